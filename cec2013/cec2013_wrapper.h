@@ -1,6 +1,8 @@
 // cec2013/cec2013_wrapper.h
 #pragma once
 #include <vector>
+#include <string>
+#include <unistd.h>
 #include "test_func.h"  // Use your existing header
 
 class CEC2013Benchmark {
@@ -26,6 +28,32 @@ public:
         return fitness;
     }
     
+    //Evaluate m points stored row-major in X (m x dim) with one call
+    void evaluateBatch(const double* X, int m, double* f) {
+        test_func(const_cast<double*>(X), f, dim, m, func_num);
+    }
+    
+    //Time the shift/rotate and cf_cal stages of evaluations in this thread
+    static void enableStageTiming(bool on) {
+        cec13_stage_timing = on ? 1 : 0;
+        cec13_stage_ns[0] = cec13_stage_ns[1] = 0.0;
+    }
+    
+    //Nanoseconds timed since enabling or the previous call; restarts from zero
+    static void takeStageTimes(double& shift_rotate_ns, double& cf_cal_ns) {
+        shift_rotate_ns = cec13_stage_ns[0];
+        cf_cal_ns = cec13_stage_ns[1];
+        cec13_stage_ns[0] = cec13_stage_ns[1] = 0.0;
+    }
+    
+    //Whether the reference code can evaluate func_num at dimension: its input
+    //files exist under the working directory. It reads them unchecked, so a
+    //missing file would crash it.
+    static bool isDefined(int func_num, int dimension) {
+        (void)func_num;
+        return access(("input_data/M_D" + std::to_string(dimension) + ".txt").c_str(), R_OK) == 0;
+    }
+    
     static void getBounds(int func_num, double& lb, double& ub) {
         if (func_num >= 1 && func_num <= 5) {
             lb = -100.0; ub = 100.0;
@@ -8,6 +8,7 @@
 //#include <WINDOWS.H>      
 #include <stdio.h>
 #include <math.h>
+#include <time.h>
 //#include <malloc.h>
 #include "test_func.h"
 
@@ -49,8 +50,25 @@ void asyfunc (double *, double *x, int, double);
 void oszfunc (double *, double *, int);
 void cf_cal(double *, double *, int, double *,double *,double *,double *,int);
 
-extern double *OShift,*M,*y,*z,*x_bound;;
-extern int ini_flag,n_flag,func_flag;
+extern __thread double *OShift,*M,*y,*z,*x_bound;
+extern __thread int ini_flag,n_flag,func_flag;
+
+/* Shared with the CEC17 code, which owns the data above */
+extern "C" void cec_free_thread_data(void);
+extern "C" void cec_track_thread_data(void);
+
+/* Optional stage timing for profiling: nanoseconds this thread spends in
+   shift/rotate (shiftfunc, rotatefunc) and in cf_cal while cec13_stage_timing
+   is nonzero */
+__thread int cec13_stage_timing;
+__thread double cec13_stage_ns[2];
+
+static double stage_clock(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec*1e9+ts.tv_nsec;
+}
 
 void test_func(double *x, double *f, int nx, int mx,int func_num)
 {
@@ -67,11 +85,8 @@ void test_func(double *x, double *f, int nx, int mx,int func_num)
 	{
 		FILE *fpt;
 		char FileName[30];
-		free(M);
-		free(OShift);
-		free(y);
-		free(z);
-		free(x_bound);
+		cec_free_thread_data();
+		cec_track_thread_data();
 		y=(double *)malloc(sizeof(double)  *  nx);
 		z=(double *)malloc(sizeof(double)  *  nx);
 		x_bound=(double *)malloc(sizeof(double)  *  nx);
@@ -982,15 +997,19 @@ void cf08 (double *x, double *f, int nx, double *Os,double *Mr,int r_flag) /* Co
 void shiftfunc (double *x, double *xshift, int nx,double *Os)
 {
 	int i;
+	double t0=cec13_stage_timing ? stage_clock() : 0.0;
     for (i=0; i<nx; i++)
     {
         xshift[i]=x[i]-Os[i];
     }
+	if (cec13_stage_timing)
+		cec13_stage_ns[0]+=stage_clock()-t0;
 }
 
 void rotatefunc (double *x, double *xrot, int nx,double *Mr)
 {
 	int i,j;
+	double t0=cec13_stage_timing ? stage_clock() : 0.0;
     for (i=0; i<nx; i++)
     {
         xrot[i]=0;
@@ -999,6 +1018,8 @@ void rotatefunc (double *x, double *xrot, int nx,double *Mr)
 				xrot[i]=xrot[i]+x[j]*Mr[i*nx+j];
 			}
     }
+	if (cec13_stage_timing)
+		cec13_stage_ns[0]+=stage_clock()-t0;
 }
 
 void asyfunc (double *x, double *xasy, int nx, double beta)
@@ -1050,6 +1071,7 @@ void cf_cal(double *x, double *f, int nx, double *Os,double * delta,double * bia
 	int i,j;
 	double *w;
 	double w_max=0,w_sum=0;
+	double t0=cec13_stage_timing ? stage_clock() : 0.0;
 	w=(double *)malloc(cf_num * sizeof(double));
 	for (i=0; i<cf_num; i++)
 	{
@@ -1083,5 +1105,7 @@ void cf_cal(double *x, double *f, int nx, double *Os,double * delta,double * bia
 		f[0]=f[0]+w[i]/w_sum*fit[i];
     }
 	free(w);
+	if (cec13_stage_timing)
+		cec13_stage_ns[1]+=stage_clock()-t0;
 }
 
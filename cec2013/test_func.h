@@ -7,6 +7,11 @@ extern "C" {
 
 void test_func(double *x, double *f, int nx, int mx, int func_num);
 
+/* Stage timing in this thread: set cec13_stage_timing to accumulate the
+   nanoseconds of shift/rotate (0) and cf_cal (1) in cec13_stage_ns */
+extern __thread int cec13_stage_timing;
+extern __thread double cec13_stage_ns[2];
+
 #ifdef __cplusplus
 }
 #endif
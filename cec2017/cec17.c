@@ -5,21 +5,29 @@
 
 void cec17_test_func(double *x, double *f, int nx, int mx,int func_num);
 
-static int dimension;
-static int funcid;
-static int count;
-static int ratios[] = {1, 2, 3, 5, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100};
-static int max_evals;
-static int max_ratios = 14;
-static int last_ratio = 0;
-static char fname[300];
-static double best;
-static char directory[30];
-static int print_output = 0;
+/* Per-thread state, so runs on several threads do not share counters */
+static __thread int dimension;
+static __thread int funcid;
+static __thread int count;
+static const int ratios[] = {1, 2, 3, 5, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100};
+static __thread int max_evals;
+static const int max_ratios = 14;
+static __thread int last_ratio = 0;
+static __thread char fname[300];
+static __thread double best;
+static __thread char directory[30];
+static __thread int print_output = 0;
+
+/* Milestones reached since the last flush, written in one go by cec17_flush */
+static __thread int milestone_ratio[14];
+static __thread double milestone_error[14];
+static __thread int milestones_pending = 0;
 
 void cec17_init(const char *algname, int fid, int size) {
   assert (fid > 0 && fid <= 30);
   assert (size == 2 || size == 5 || size == 10 || size == 30 || size == 50 || size == 100);
+  /* Milestones of a previous run cut short are written under its own name */
+  cec17_flush();
   funcid = fid;
   dimension = size;
   count = 0;
@@ -41,9 +49,48 @@ double cec17_error(double fitness) {
   return fitness - optimum;
 }
 
+void cec17_flush(void) {
+  FILE *output;
+  int exists = 0, k;
+
+  if (milestones_pending == 0) {
+    return;
+  }
+
+  if (print_output == 1) {
+    for (k = 0; k < milestones_pending; k++) {
+      printf("%d,%d,%d,%e\n", funcid, dimension, milestone_ratio[k], milestone_error[k]);
+    }
+    fflush(stdout);
+    milestones_pending = 0;
+    return;
+  }
+
+  FILE *ver = fopen(fname, "r");
+  if (ver != NULL) {
+    exists = 1;
+    fclose(ver);
+  }
+
+  output = fopen(fname, "a");
+
+  if (output == NULL) {
+    fprintf(stderr, "Error, it cannot be possible to create file '%s', the directory '%s' exists?\n", fname, directory);
+    exit(1);
+  }
+
+  if (!exists) {
+    fprintf(output, "funcid,dim,milestone,error\n");
+  }
+  for (k = 0; k < milestones_pending; k++) {
+    fprintf(output, "%d,%d,%d,%e\n", funcid, dimension, milestone_ratio[k], milestone_error[k]);
+  }
+  fclose(output);
+  milestones_pending = 0;
+}
+
 double cec17_fitness(double *sol) {
   double fit;
-  static FILE *output  = NULL;
   int ratio;
 
   cec17_test_func(sol, &fit, dimension, 1, funcid);
@@ -60,39 +107,15 @@ double cec17_fitness(double *sol) {
 
   ratio = count*100/max_evals;
 
+  /* Milestones are kept in memory; the file is written once per run */
   if (ratio >= ratios[last_ratio]) {
-    if (output == NULL && print_output == 0) {
-      int exists = 0;
-      FILE *ver = fopen(fname, "r");
-      if (ver != NULL) {
-        exists = 1;
-        fclose(ver);
-      }
-
-      output = fopen(fname, "a");
-
-      if (output == NULL) {
-        fprintf(stderr, "Error, it cannot be possible to create file '%s', the directory '%s' exists?\n", fname, directory);
-        exit(1);
-      }
-
-      if (!exists) {
-        fprintf(output, "funcid,dim,milestone,error\n");
-      }
-    }
-
-    if (print_output == 1) {
-      printf("%d,%d,%d,%e\n", funcid, dimension, ratio, cec17_error(best));
-      fflush(stdout);
-    }
-    else {
-      fprintf(output, "%d,%d,%d,%e\n", funcid, dimension, ratio, cec17_error(best));
-      fclose(output);
-      output = NULL;
-    }
+    milestone_ratio[milestones_pending] = ratio;
+    milestone_error[milestones_pending] = cec17_error(best);
+    milestones_pending += 1;
     last_ratio += 1;
 
     if (last_ratio >= max_ratios) {
+      cec17_flush();
       last_ratio = 0;
     }
 
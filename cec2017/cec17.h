@@ -11,6 +11,7 @@
 
 /**
  * Inicia la función de evaluación y la dimensión.
+ * Antes escribe los hitos pendientes de la ejecución anterior.
  * @param algname (results will be copy to results_algname directory).
  * @param funcid debe ser entre 1 y 30.
  * @param dimension debe ser 2, 5, 10, 30, o 50.
@@ -37,4 +38,12 @@ double cec17_error(double fitness);
  */
 double cec17_fitness(double *sol);
 
+/**
+ * Escribe los hitos guardados en memoria que aún no se han escrito
+ * (se llama sola al llegar al último hito de la ejecución y al iniciar
+ * otra con cec17_init). Llamarla al terminar el programa, y al terminar
+ * cada hilo que evalúe, para no perder los hitos de una ejecución cortada.
+ */
+void cec17_flush(void);
+
 #endif
@@ -7,6 +7,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <time.h>
+#include <pthread.h>
 
 #define INF 1.0e99
 #define EPS 1.0e-14
@@ -68,8 +70,58 @@ void asyfunc (double *, double *x, int, double);
 void oszfunc (double *, double *, int);
 void cf_cal(double *, double *, int, double *,double *,double *,double *,int);
 
-double *OShift,*M,*y,*z,*x_bound;
-int ini_flag,n_flag,func_flag,*SS;
+/* Thread-local so that every thread (e.g. each island) keeps its own loaded data */
+__thread double *OShift,*M,*y,*z,*x_bound;
+__thread int ini_flag,n_flag,func_flag,*SS;
+
+/* Frees the data loaded by this thread; its next evaluation loads it again.
+   Runs by itself when a thread that loaded data exits */
+void cec_free_thread_data(void)
+{
+	free(M);
+	free(OShift);
+	free(y);
+	free(z);
+	free(x_bound);
+	free(SS);
+	M=OShift=y=z=x_bound=NULL;
+	SS=NULL;
+	ini_flag=0;
+}
+
+static pthread_key_t thread_data_key;
+static pthread_once_t thread_data_once=PTHREAD_ONCE_INIT;
+
+static void thread_data_exit(void *unused)
+{
+	(void)unused;
+	cec_free_thread_data();
+}
+
+static void thread_data_key_create(void)
+{
+	pthread_key_create(&thread_data_key, thread_data_exit);
+}
+
+/* Registers this thread for the cleanup at exit (a non-null key value) */
+void cec_track_thread_data(void)
+{
+	pthread_once(&thread_data_once, thread_data_key_create);
+	pthread_setspecific(thread_data_key, &thread_data_key);
+}
+
+/* Optional stage timing for profiling: nanoseconds this thread spends in
+   shift/rotate (shiftfunc, rotatefunc) and in cf_cal while cec17_stage_timing
+   is nonzero */
+__thread int cec17_stage_timing;
+__thread double cec17_stage_ns[2];
+
+static double stage_clock(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec*1e9+ts.tv_nsec;
+}
 
 
 void cec17_test_func(double *x, double *f, int nx, int mx,int func_num)
@@ -87,11 +139,8 @@ void cec17_test_func(double *x, double *f, int nx, int mx,int func_num)
 	{
 		FILE *fpt;
 		char FileName[256];
-		free(M);
-		free(OShift);
-		free(y);
-		free(z);
-		free(x_bound);
+		cec_free_thread_data();
+		cec_track_thread_data();
 		y=(double *)malloc(sizeof(double)  *  nx);
 		z=(double *)malloc(sizeof(double)  *  nx);
 		x_bound=(double *)malloc(sizeof(double)  *  nx);
@@ -1493,15 +1542,19 @@ void cf10 (double *x, double *f, int nx, double *Os,double *Mr,int *SS,int r_fla
 void shiftfunc (double *x, double *xshift, int nx,double *Os)
 {
 	int i;
+	double t0=cec17_stage_timing ? stage_clock() : 0.0;
     for (i=0; i<nx; i++)
     {
         xshift[i]=x[i]-Os[i];
     }
+	if (cec17_stage_timing)
+		cec17_stage_ns[0]+=stage_clock()-t0;
 }
 
 void rotatefunc (double *x, double *xrot, int nx,double *Mr)
 {
 	int i,j;
+	double t0=cec17_stage_timing ? stage_clock() : 0.0;
     for (i=0; i<nx; i++)
     {
         xrot[i]=0;
@@ -1510,6 +1563,8 @@ void rotatefunc (double *x, double *xrot, int nx,double *Mr)
 				xrot[i]=xrot[i]+x[j]*Mr[i*nx+j];
 			}
     }
+	if (cec17_stage_timing)
+		cec17_stage_ns[0]+=stage_clock()-t0;
 }
 
 void sr_func (double *x, double *sr_x, int nx, double *Os,double *Mr, double sh_rate, int s_flag,int r_flag) /* shift and rotate */
@@ -1603,6 +1658,7 @@ void cf_cal(double *x, double *f, int nx, double *Os,double * delta,double * bia
 	int i,j;
 	double *w;
 	double w_max=0,w_sum=0;
+	double t0=cec17_stage_timing ? stage_clock() : 0.0;
 	w=(double *)malloc(cf_num * sizeof(double));
 	for (i=0; i<cf_num; i++)
 	{
@@ -1636,4 +1692,6 @@ void cf_cal(double *x, double *f, int nx, double *Os,double * delta,double * bia
 		f[0]=f[0]+w[i]/w_sum*fit[i];
     }
 	free(w);
+	if (cec17_stage_timing)
+		cec17_stage_ns[1]+=stage_clock()-t0;
 }
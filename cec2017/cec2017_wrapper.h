@@ -1,10 +1,16 @@
 //cec2017/cec2017_wrapper.h
 #pragma once
 #include <vector>
+#include <string>
+#include <unistd.h>
 
 //Forward declaration - check the actual function name in CEC 2017 code
 extern "C" {
     void cec17_test_func(double*, double*, int, int, int);
+
+    //Stage timing of this thread: shift/rotate (0) and cf_cal (1) nanoseconds
+    extern __thread int cec17_stage_timing;
+    extern __thread double cec17_stage_ns[2];
 }
 
 class CEC2017Benchmark {
@@ -30,6 +36,34 @@ public:
         return fitness;
     }
     
+    //Evaluate m points stored row-major in X (m x dim) with one call
+    void evaluateBatch(const double* X, int m, double* f) {
+        cec17_test_func(const_cast<double*>(X), f, dim, m, func_num);
+    }
+    
+    //Time the shift/rotate and cf_cal stages of evaluations in this thread
+    static void enableStageTiming(bool on) {
+        cec17_stage_timing = on ? 1 : 0;
+        cec17_stage_ns[0] = cec17_stage_ns[1] = 0.0;
+    }
+    
+    //Nanoseconds timed since enabling or the previous call; restarts from zero
+    static void takeStageTimes(double& shift_rotate_ns, double& cf_cal_ns) {
+        shift_rotate_ns = cec17_stage_ns[0];
+        cf_cal_ns = cec17_stage_ns[1];
+        cec17_stage_ns[0] = cec17_stage_ns[1] = 0.0;
+    }
+    
+    //Whether the reference code can evaluate func_num at dimension: defined
+    //there (hybrid and some composition functions not at D=2) and its input
+    //files exist under the working directory. It reads them unchecked, so a
+    //missing file would crash it.
+    static bool isDefined(int func_num, int dimension) {
+        if(dimension == 2 && ((func_num >= 17 && func_num <= 22) || func_num >= 29)) return false;
+        std::string file = "input_data/M_" + std::to_string(func_num) + "_D" + std::to_string(dimension) + ".txt";
+        return access(file.c_str(), R_OK) == 0;
+    }
+    
     static void getBounds(int func_num, double& lb, double& ub) {
         //Most CEC 2017 functions use [-100, 100]
         lb = -100.0;
@@ -21,7 +21,8 @@ public:
     
     //Determine which particle (Er or Ei) should be active for this layer
     //Returns: 0 = reconstruct Q, 1 = use Er, 2 = use Ei
-    int selectParticle(Layer& layer, int M_Er, int M_Ei) {
+    template<class LayerT>
+    int selectParticle(const LayerT& layer, int M_Er, int M_Ei) {
         //Condition 3 (reconstruction): (β ≠ 0 && α_Er > M_Er) || α_Ei > M_Ei
         if ((layer.beta != 0 && layer.Er.alpha > M_Er) || layer.Ei.alpha > M_Ei) {
             return 0; // Reconstruct
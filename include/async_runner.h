@@ -0,0 +1,207 @@
+#pragma once
+#include "chxpso_abs.h"
+#include "trace.h"
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <limits>
+
+//Asynchronous evaluation mode: candidates are evaluated on a pool of worker
+//threads and told to the optimizer as each one completes, so a slow
+//evaluation only holds back its own layer. Each layer is asked with the
+//gbest snapshot current at that moment and its R&P update is applied on
+//completion. Optimizer state is only touched by the calling (coordinator)
+//thread; the objective must be safe to call from several threads at once.
+//A timeout only stops the optimizer waiting for a result: the evaluation
+//itself cannot be interrupted, keeps its worker busy and is still joined
+//before run() returns, so a hung objective also hangs run().
+class AsyncRunner {
+    struct Job {
+        long long id;
+        std::vector<double> x;      //Copy, the optimizer may move the layer after a timeout
+        double bound;
+    };
+
+    struct Done {
+        long long id;
+        double fit;
+    };
+
+    struct Outstanding {
+        long long id;               //0: no candidate in flight for this layer
+        SwarmCandidate c;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    int num_workers;
+    double timeout;                 //Seconds, <= 0 disables timeouts
+
+    std::mutex mtx;
+    std::condition_variable job_cv;
+    std::condition_variable done_cv;
+    std::deque<Job> jobs;
+    std::deque<Done> results;
+    bool stopping = false;
+
+    std::atomic<double> best_fit;
+    long long timeouts = 0;
+    long long stale_results = 0;
+
+    void worker(int index, const std::function<double(const std::vector<double>&, double)>& eval) {
+        TraceLog::nameThread("async worker " + std::to_string(index));
+        for(;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                job_cv.wait(lock, [this] { return stopping || !jobs.empty(); });
+                if(jobs.empty()) return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+
+            double fit;
+            {
+                TraceSpan span("evaluate", "objective", TRACE_EVALUATIONS);
+                fit = eval(job.x, job.bound);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                results.push_back(Done{job.id, fit});
+            }
+            done_cv.notify_one();
+        }
+    }
+
+public:
+    AsyncRunner(int num_workers_, double timeout_seconds = 0.0)
+        : num_workers(num_workers_ > 0 ? num_workers_ : 1), timeout(timeout_seconds),
+          best_fit(std::numeric_limits<double>::infinity()) {}
+
+    //Run opt to completion with a plain objective
+    template<class Swarm>
+    void run(Swarm& opt, std::function<double(const std::vector<double>&)> objective) {
+        run(opt, [objective](const std::vector<double>& x, double) { return objective(x); }, false);
+    }
+
+    //Run opt to completion; eval(x, bound) is a bounded objective when bounded is true
+    template<class Swarm>
+    void run(Swarm& opt,
+             std::function<double(const std::vector<double>&, double)> eval,
+             bool bounded) {
+        typedef std::chrono::steady_clock Clock;
+        TraceSpan span("async run", "optimizer");
+
+        stopping = false;
+        jobs.clear();
+        results.clear();
+
+        std::vector<std::thread> pool;
+        for(int t = 0; t < num_workers; ++t) {
+            pool.emplace_back(&AsyncRunner::worker, this, t, std::cref(eval));
+        }
+
+        std::vector<Outstanding> outstanding;   //Indexed by layer
+        long long next_id = 1;
+        int busy = 0;                           //Jobs queued or running, including timed-out ones
+
+        while(!opt.done()) {
+            //Keep every worker supplied
+            if(busy < num_workers) {
+                std::vector<SwarmCandidate> batch = opt.ask(num_workers - busy);
+                if(!batch.empty()) {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    for(const SwarmCandidate& c : batch) {
+                        if(c.layer >= static_cast<int>(outstanding.size())) {
+                            outstanding.resize(c.layer + 1, Outstanding{0, c, Clock::time_point()});
+                        }
+                        Clock::time_point deadline = Clock::now() +
+                            std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(timeout));
+                        outstanding[c.layer] = Outstanding{next_id, c, deadline};
+                        jobs.push_back(Job{next_id, *c.x, c.bound});
+                        next_id++;
+                        busy++;
+                    }
+                }
+                job_cv.notify_all();
+            }
+            if(opt.done()) break;
+
+            //Wait for a completion or the earliest deadline
+            std::vector<Done> completed;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                bool live = false;
+                Clock::time_point earliest;
+                if(timeout > 0.0) {
+                    for(const Outstanding& o : outstanding) {
+                        if(o.id != 0 && (!live || o.deadline < earliest)) {
+                            earliest = o.deadline;
+                            live = true;
+                        }
+                    }
+                }
+                if(live) {
+                    done_cv.wait_until(lock, earliest, [this] { return !results.empty(); });
+                } else {
+                    done_cv.wait(lock, [this] { return !results.empty(); });
+                }
+                completed.assign(results.begin(), results.end());
+                results.clear();
+            }
+
+            for(const Done& d : completed) {
+                busy--;
+                Outstanding* match = nullptr;
+                for(Outstanding& o : outstanding) {
+                    if(o.id == d.id) { match = &o; break; }
+                }
+                if(!match) {
+                    stale_results++;    //Already told as a failure
+                    continue;
+                }
+                match->id = 0;
+                opt.tell(match->c, d.fit, !bounded || d.fit < match->c.bound);
+
+                double best = opt.getGBestFitness();
+                if(best < best_fit.load(std::memory_order_relaxed)) {
+                    best_fit.store(best, std::memory_order_relaxed);
+                }
+            }
+
+            //Stragglers past their deadline count as failures
+            if(timeout > 0.0) {
+                Clock::time_point now = Clock::now();
+                for(Outstanding& o : outstanding) {
+                    if(o.id != 0 && o.deadline <= now) {
+                        o.id = 0;
+                        timeouts++;
+                        TraceLog::instant("timeout", "objective");
+                        opt.tellFailure(o.c);
+                    }
+                }
+            }
+        }
+
+        //Timed-out evaluations still running are waited for here; see the
+        //class comment
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        job_cv.notify_all();
+        for(std::thread& t : pool) {
+            t.join();
+        }
+    }
+
+    //Best fitness so far; safe to read from other threads while run() is active
+    double bestFitness() const { return best_fit.load(std::memory_order_relaxed); }
+    long long getTimeouts() const { return timeouts; }
+    long long getStaleResults() const { return stale_results; }
+};
@@ -47,6 +47,112 @@ inline double ackley(const std::vector<double>& x) {
            - std::exp(sum2 / n) + 20.0 + std::exp(1.0);
 }
 
+//Bounded variants: stop as soon as the partial sum reaches bound.
+//Exact (same summation order as above) whenever the result is below bound.
+inline double sphere_bounded(const std::vector<double>& x, double bound) {
+    double sum = 0.0;
+    for(double xi : x) {
+        sum += xi * xi;
+        if(sum >= bound) return sum;
+    }
+    return sum;
+}
+
+inline double rastrigin_bounded(const std::vector<double>& x, double bound) {
+    double sum = 0.0;
+    const double A = 10.0;
+    const double pi = 3.14159265358979323846;
+    
+    //Every term xi^2 - A*cos(2*pi*xi) is >= -A, so after i+1 terms
+    //A*(i+1) + sum is a lower bound of the final value
+    for(size_t i = 0; i < x.size(); ++i) {
+        sum += x[i] * x[i] - A * std::cos(2 * pi * x[i]);
+        if(A * (i + 1) + sum >= bound) return A * (i + 1) + sum;
+    }
+    return A * x.size() + sum;
+}
+
+inline double rosenbrock_bounded(const std::vector<double>& x, double bound) {
+    double sum = 0.0;
+    for(size_t i = 0; i < x.size() - 1; ++i) {
+        double term1 = x[i+1] - x[i] * x[i];
+        double term2 = x[i] - 1.0;
+        sum += 100.0 * term1 * term1 + term2 * term2;
+        if(sum >= bound) return sum;
+    }
+    return sum;
+}
+
+//Batch variants: X is dimension-major (dim x m, X[d*m + j] is coordinate d
+//of candidate j). The inner loops run across candidates, so they map onto
+//SIMD lanes without horizontal reductions, and each candidate's sum is
+//accumulated in the same order as the scalar version above.
+inline void sphere_batch(const double* X, int dim, int m, double* f) {
+    for(int j = 0; j < m; ++j) f[j] = 0.0;
+    for(int d = 0; d < dim; ++d) {
+        const double* xd = X + static_cast<size_t>(d) * m;
+        for(int j = 0; j < m; ++j) {
+            f[j] += xd[j] * xd[j];
+        }
+    }
+}
+
+inline void rastrigin_batch(const double* X, int dim, int m, double* f) {
+    const double A = 10.0;
+    const double pi = 3.14159265358979323846;
+    
+    for(int j = 0; j < m; ++j) f[j] = 0.0;
+    for(int d = 0; d < dim; ++d) {
+        const double* xd = X + static_cast<size_t>(d) * m;
+        for(int j = 0; j < m; ++j) {
+            f[j] += xd[j] * xd[j] - A * std::cos(2 * pi * xd[j]);
+        }
+    }
+    for(int j = 0; j < m; ++j) f[j] = A * dim + f[j];
+}
+
+inline void rosenbrock_batch(const double* X, int dim, int m, double* f) {
+    for(int j = 0; j < m; ++j) f[j] = 0.0;
+    for(int d = 0; d < dim - 1; ++d) {
+        const double* xd = X + static_cast<size_t>(d) * m;
+        const double* xn = xd + m;
+        for(int j = 0; j < m; ++j) {
+            double term1 = xn[j] - xd[j] * xd[j];
+            double term2 = xd[j] - 1.0;
+            f[j] += 100.0 * term1 * term1 + term2 * term2;
+        }
+    }
+}
+
+//Candidates are taken in blocks so the second sum fits a stack array
+inline void ackley_batch(const double* X, int dim, int m, double* f) {
+    const double pi = 3.14159265358979323846;
+    const int block = 64;
+    double sum2[block];
+    double n = static_cast<double>(dim);
+    
+    for(int start = 0; start < m; start += block) {
+        int b = m - start < block ? m - start : block;
+        double* fb = f + start;
+        for(int j = 0; j < b; ++j) {
+            fb[j] = 0.0;    //sum1
+            sum2[j] = 0.0;
+        }
+        for(int d = 0; d < dim; ++d) {
+            const double* xd = X + static_cast<size_t>(d) * m + start;
+            for(int j = 0; j < b; ++j) {
+                fb[j] += xd[j] * xd[j];
+                sum2[j] += std::cos(2 * pi * xd[j]);
+            }
+        }
+        
+        for(int j = 0; j < b; ++j) {
+            fb[j] = -20.0 * std::exp(-0.2 * std::sqrt(fb[j] / n))
+                    - std::exp(sum2[j] / n) + 20.0 + std::exp(1.0);
+        }
+    }
+}
+
 //CEC 2013 Wrapper - include the wrapper file, not the implementation
 #ifdef USE_CEC2013
 #include "../cec2013/cec2013_wrapper.h"
@@ -1,15 +1,59 @@
 #pragma once
 #include "particle.h"
 #include "abs_strategy.h"
+#include "eval_cache.h"
+#include "surrogate.h"
+#include "swarm_policies.h"
+#include "observer.h"
+#include "profiler.h"
+#include "trace.h"
+#include "convergence.h"
 #include <vector>
 #include <functional>
 #include <random>
-#include <iostream>
 #include <algorithm>
 #include <cmath>
+#include <limits>
+#include <memory>
 
-class CHxPSO_ABS {
+//Conversion to double at the objective boundary: the vector itself in double
+//mode, otherwise a copy in buffer
+inline const std::vector<double>& asDouble(const std::vector<double>& x, std::vector<double>&) {
+    return x;
+}
+
+template<class Real>
+const std::vector<double>& asDouble(const std::vector<Real>& x, std::vector<double>& buffer) {
+    buffer.assign(x.begin(), x.end());
+    return buffer;
+}
+
+//A position to be evaluated. x stays valid and unchanged until the
+//candidate is told; each layer has at most one candidate in flight.
+struct SwarmCandidate {
+    int layer;
+    Role role;                      //Particle that moved (ER for initial samples)
+    bool initial;                   //Initial sample of the layer's L vector
+    const std::vector<double>* x;
+    double bound;                   //Layer's L_fit when asked, for bounded evaluation
+};
+
+//CHxPSO-ABS engine. Real is the precision of the swarm state (x, v, L, Q,
+//gbest); positions are converted to double for the objective, cache and
+//surrogate, and fitness values and parameter schedules stay double. The
+//variant is fixed at compile time by its policies (see swarm_policies.h):
+//Exemplar builds Q (and reset() returns it to its defaults, keeping its
+//buffers), Update gives the channel velocity rule, Schedule the
+//time-varying coefficients and Boundary the box handling.
+template<class Real, class Exemplar,
+         class Update = StandardUpdate, class Schedule = LinearSchedule, class Boundary = ClampBoundary>
+class CHxPSO {
+    friend Exemplar;
+    
 protected:
+    typedef BasicParticle<Real> Particle;
+    typedef BasicLayer<Real> Layer;
+    
     int N;                      //Number of layers (population size)
     int dim;
     int max_FEs;                //Maximum function evaluations
@@ -17,52 +61,401 @@ protected:
     int FEs;                    //Current function evaluations
     
     std::vector<Layer> layers;
-    std::vector<double> gbest;
+    std::vector<Real> gbest;
     double gbest_fit;
     ABSStrategy abs;
     
     std::function<double(const std::vector<double>&)> objective;
     
+    //Optional bounded objective f(x, bound): must be exact whenever the result
+    //is below bound, otherwise it may stop early and return any value >= bound
+    std::function<double(const std::vector<double>&, double)> bounded_objective;
+    
+    std::unique_ptr<EvaluationCache> cache;  //Optional, see enableEvaluationCache()
+    
+    //Optional surrogate pre-screening, see enableSurrogate()
+    std::unique_ptr<SurrogateModel> surrogate;
+    double surrogate_z = 2.0;               //Confidence: reject if mean - z*sigma >= L_fit
+    int surrogate_max_streak = 10;          //Force a true evaluation after this many rejections in a row
+    int surrogate_streak = 0;
+    
+    long long true_evaluations = 0;         //Calls that reached the objective
+    long long surrogate_evaluations = 0;    //Surrogate predictions made
+    long long surrogate_rejections = 0;     //Candidates rejected without a true evaluation
+    
+    //Ask/tell state
+    bool initialized = false;
+    std::vector<char> pending;              //Layer has a candidate in flight
+    int in_flight = 0;
+    int init_remaining = 0;                 //Initial samples not yet told
+    int next_layer = 0;                     //Position of the current sweep over the layers
+    bool sweep_open = false;
+    int M_Er = 0, M_Ei = 0;                 //ABS thresholds of the current sweep
+    
+    //Exemplar pool extension: solutions received from other swarms
+    std::vector<std::vector<Real>> migrants;
+    std::vector<double> migrant_fit;
+    int max_migrants;
+    
     std::mt19937 gen;
     std::uniform_real_distribution<double> dis;
+    std::vector<Real> uniforms;             //Random numbers of one particle update
+    std::vector<std::vector<double>> eval_buffers;  //Per layer: candidate in double (float mode only)
     
     double x_min = -100.0;
     double x_max = 100.0;
     double v_max = 0.2 * (x_max - x_min);  //Typical PSO velocity limit
     
-    //Time-varying parameters (initial and final values)
-    double w_init = 0.99, w_final = 0.2;
-    double c_init = 3.0, c_final = 1.5;
-    double c1_init = 2.5, c1_final = 0.5;
+    Exemplar exemplar_policy;
+    Schedule schedule;
+    
+    SwarmObserver* observer = nullptr;      //Optional, see setObserver()
+    PhaseProfiler* profiler = nullptr;      //Optional, see setProfiler()
+    ConvergenceRecorder* convergence = nullptr;  //Optional, see setConvergenceRecorder()
+    
+    //Evaluate x for an R&P comparison against bound (the layer's L_fit)
+    double evaluate(const std::vector<double>& x, double bound) {
+        ProfileScope scope(profiler, PHASE_EVALUATE);
+        TraceSpan span("evaluate", "objective", TRACE_EVALUATIONS);
+        if(bounded_objective) {
+            return bounded_objective(x, bound);
+        }
+        return objective(x);
+    }
+    
+    //Exemplar pool: the N layers' L vectors followed by any migrants
+    int exemplarPoolSize() const { return N + static_cast<int>(migrants.size()); }
+    const std::vector<Real>& exemplar(int k) const {
+        return k < N ? layers[k].L : migrants[k - N];
+    }
+    
+    //x as seen by the objective for layer n's candidate; valid until it is told
+    const std::vector<double>& toObjective(int n, const std::vector<Real>& x) {
+        return asDouble(x, eval_buffers[n]);
+    }
+    
+    //FEs used by the parameter schedules, counting candidates in flight
+    int scheduleFEs() const { return FEs + in_flight; }
+    
+    void beginSweep() {
+        int old_Er = M_Er, old_Ei = M_Ei;
+        {
+            ProfileScope scope(profiler, PHASE_THRESHOLDS);
+            abs.calculateThresholds(FEs, max_FEs, M_Er, M_Ei);
+        }
+        next_layer = 0;
+        sweep_open = true;
+        
+        if(observer && (M_Er != old_Er || M_Ei != old_Ei)) {
+            observer->onThresholds(FEs, M_Er, M_Ei);
+        }
+    }
     
-    //Calculate linearly decreasing parameter
-    double getLinearParam(double init, double final, int current_FEs, int max_FEs) {
-        return init - (init - final) * static_cast<double>(current_FEs) / max_FEs;
+    void endSweep() {
+        if(!sweep_open) return;
+        sweep_open = false;
+        if(observer) observer->onSweepEnd(FEs, gbest_fit);
+    }
+    
+    //ABS action for layer: 0 reconstruct Q, 1 move Er, 2 move Ei
+    int selectAction(const Layer& layer) {
+        ProfileScope scope(profiler, PHASE_SELECT);
+        return abs.selectParticle(layer, M_Er, M_Ei);
+    }
+    
+    void notifyImprovement() {
+        if(observer) observer->onImprovement(FEs, gbest_fit);
+    }
+    
+    //After every change of FEs, once gbest reflects the evaluation
+    void recordConvergence() {
+        if(convergence) convergence->update(FEs, gbest_fit);
+    }
+    
+    //Complete the in-flight candidate of layer n with its fitness
+    void resolveCandidate(int n, Role role, bool initial, double fit) {
+        Layer& layer = layers[n];
+        pending[n] = 0;
+        in_flight--;
+        FEs++;
+        
+        if(initial) {
+            layer.L_fit = fit;
+            
+            //Update global best
+            if(layer.L_fit < gbest_fit) {
+                gbest_fit = layer.L_fit;
+                gbest = layer.L;
+                notifyImprovement();
+            }
+            
+            if(--init_remaining == 0) {
+                //Construct initial Q vectors
+                for(int i = 0; i < N; ++i) {
+                    constructQ(i);
+                }
+                next_layer = N;  //First search sweep starts at the next ask()
+            }
+            recordConvergence();
+            return;
+        }
+        
+        applyResult(n, role, fit);
+        recordConvergence();
+    }
+    
+    //R&P box for a moved particle of layer n
+    void applyResult(int n, Role role, double fit) {
+        Layer& layer = layers[n];
+        
+        if(role == ER) {
+            //R&P box for Er particle (fit may be a lower bound when rejected)
+            if(fit >= layer.L_fit) {
+                layer.Er.alpha = layer.Er.alpha + 1;
+            } else {
+                layer.Er.alpha = 0;
+                layer.beta = layer.beta + 1;
+                layer.L = layer.Er.x;
+                layer.L_fit = fit;
+                
+                if(fit < gbest_fit) {
+                    gbest_fit = fit;
+                    gbest = layer.L;
+                    notifyImprovement();
+                }
+            }
+        } else {
+            //R&P box for Ei particle
+            if(fit >= layer.L_fit) {
+                layer.Ei.alpha = layer.Ei.alpha + 1;
+            } else {
+                //If only L is updated, keep alpha unchanged
+                //If G is updated, reset alpha to 0
+                layer.L = layer.Ei.x;
+                layer.L_fit = fit;
+                
+                if(fit < gbest_fit) {
+                    gbest_fit = fit;
+                    gbest = layer.L;
+                    notifyImprovement();
+                    layer.Ei.alpha = 0;  //Reset when G is updated
+                }
+                //else: alpha unchanged (reward one more time)
+            }
+        }
+    }
+    
+    //Velocity (Update policy) and position update of one particle with
+    //clamping and boundary handling (Boundary policy). D > 0 fixes the
+    //width at compile time so the loop is fully unrolled/vectorized with no
+    //tail; D == 0 is the runtime-width fallback. The random numbers r are
+    //drawn beforehand in dimension order, so every width gives the same
+    //trajectory as a per-dimension loop.
+    template<int D, bool Ei>
+    static void moveParticle(Real* __restrict x, Real* __restrict v, const Real* __restrict Q,
+                             const Real* __restrict G, const Real* __restrict r, int n,
+                             Real w, Real c, Real v_max, Real x_min, Real x_max) {
+        if(D > 0) n = D;
+        for(int d = 0; d < n; ++d) {
+            Real vd = Update::template velocity<Ei>(v[d], x[d], Q[d], G[d], r[d], w, c);
+            
+            //Velocity clamping
+            vd = std::max(-v_max, std::min(v_max, vd));
+            
+            //Position update
+            Real xd = x[d] + vd;
+            
+            Boundary::apply(xd, vd, x_min, x_max);
+            x[d] = xd;
+            v[d] = vd;
+        }
+    }
+    
+    //Pick the kernel specialized for the standard benchmark dimensions
+    template<bool Ei>
+    void dispatchMove(Particle& p, const Layer& layer, double w, double c) {
+        uniforms.resize(dim);
+        for(int d = 0; d < dim; ++d) {
+            uniforms[d] = static_cast<Real>(dis(gen));
+        }
+        
+        Real* x = p.x.data();
+        Real* v = p.v.data();
+        const Real* Q = layer.Q.data();
+        const Real* G = gbest.data();
+        const Real* r = uniforms.data();
+        Real w_ = static_cast<Real>(w), c_ = static_cast<Real>(c);
+        Real vm = static_cast<Real>(v_max), lo = static_cast<Real>(x_min), hi = static_cast<Real>(x_max);
+        switch(dim) {
+        case 10:  moveParticle<10, Ei>(x, v, Q, G, r, dim, w_, c_, vm, lo, hi); break;
+        case 30:  moveParticle<30, Ei>(x, v, Q, G, r, dim, w_, c_, vm, lo, hi); break;
+        case 50:  moveParticle<50, Ei>(x, v, Q, G, r, dim, w_, c_, vm, lo, hi); break;
+        case 100: moveParticle<100, Ei>(x, v, Q, G, r, dim, w_, c_, vm, lo, hi); break;
+        default:  moveParticle<0, Ei>(x, v, Q, G, r, dim, w_, c_, vm, lo, hi); break;
+        }
+    }
+    
+    //Surrogate pre-screening: true if x is confidently worse than bound and
+    //can be treated as an R&P failure without a true evaluation
+    bool screenedOut(const std::vector<double>& x, double bound) {
+        if(!surrogate || !surrogate->ready()) return false;
+        if(surrogate_streak >= surrogate_max_streak) {
+            surrogate_streak = 0;
+            return false;
+        }
+        
+        double mean, sigma;
+        surrogate->predict(x, mean, sigma);
+        surrogate_evaluations++;
+        
+        if(mean - surrogate_z * sigma >= bound) {
+            surrogate_rejections++;
+            surrogate_streak++;
+            return true;
+        }
+        surrogate_streak = 0;
+        return false;
     }
     
 public:
-    CHxPSO_ABS(int N_, int dim_, int max_FEs_, int M_)
+    CHxPSO(int N_, int dim_, int max_FEs_, int M_)
         : N(N_), dim(dim_), max_FEs(max_FEs_), M(M_), FEs(0),
-          gbest_fit(1e9), abs(M_), dis(0.0, 1.0) {
+          gbest_fit(1e9), abs(M_), max_migrants(N_), dis(0.0, 1.0) {
         gen.seed(std::random_device{}());
         gbest.resize(dim);
         layers.resize(N);
+        eval_buffers.resize(N);
     }
     
-    virtual ~CHxPSO_ABS() {}
+    static const char* variantName() { return Exemplar::name(); }
+    
+    Exemplar& exemplarPolicy() { return exemplar_policy; }
+    const Exemplar& exemplarPolicy() const { return exemplar_policy; }
+    Schedule& schedulePolicy() { return schedule; }
     
     void setObjective(std::function<double(const std::vector<double>&)> obj) {
         objective = obj;
     }
     
+    //Used for R&P comparisons instead of the plain objective when set
+    void setBoundedObjective(std::function<double(const std::vector<double>&, double)> obj) {
+        bounded_objective = obj;
+    }
+    
+    //Answer repeated positions from a bounded cache instead of the objective.
+    //quantum > 0 snaps coordinates to a grid of that spacing before lookup.
+    //Cache hits are still charged to the FEs budget.
+    void enableEvaluationCache(size_t capacity, double quantum = 0.0) {
+        cache.reset(new EvaluationCache(capacity, quantum));
+    }
+    
+    const EvaluationCache* getEvaluationCache() const { return cache.get(); }
+    
+    //Pre-screen Er/Ei candidates with a k-NN surrogate trained on an archive of
+    //the last archive_size true evaluations. Rejected candidates count as R&P
+    //failures and are not charged to the FEs budget.
+    void enableSurrogate(size_t archive_size, int k = 8, double z = 2.0, int max_streak = 10) {
+        surrogate.reset(new SurrogateModel(archive_size, k));
+        surrogate_z = z;
+        surrogate_max_streak = max_streak;
+    }
+    
+    struct EvaluationStats {
+        long long FEs;                      //Budget consumed (true evaluations + cache hits)
+        long long true_evaluations;
+        long long cache_hits;
+        long long surrogate_evaluations;
+        long long surrogate_rejections;
+    };
+    
+    EvaluationStats getEvaluationStats() const {
+        EvaluationStats stats;
+        stats.FEs = FEs;
+        stats.true_evaluations = true_evaluations;
+        stats.cache_hits = cache ? cache->getStats().hits : 0;
+        stats.surrogate_evaluations = surrogate_evaluations;
+        stats.surrogate_rejections = surrogate_rejections;
+        return stats;
+    }
+    
+    //Reseed the generator (the default seed comes from std::random_device)
+    void seed(unsigned int s) {
+        gen.seed(s);
+    }
+    
+    //Return to the freshly constructed state (objective, observer, profiler,
+    //convergence recorder, cache, surrogate, bounds and migrants cleared) with
+    //generator seed s, keeping the layer vectors and buffers allocated so the
+    //next run neither allocates nor first-touches swarm memory. Requires no
+    //candidate in flight.
+    void reset(unsigned int s) {
+        FEs = 0;
+        std::fill(gbest.begin(), gbest.end(), Real(0));
+        gbest_fit = 1e9;
+        
+        objective = nullptr;
+        bounded_objective = nullptr;
+        cache.reset();
+        surrogate.reset();
+        surrogate_z = 2.0;
+        surrogate_max_streak = 10;
+        surrogate_streak = 0;
+        true_evaluations = 0;
+        surrogate_evaluations = 0;
+        surrogate_rejections = 0;
+        
+        initialized = false;
+        in_flight = 0;
+        init_remaining = 0;
+        next_layer = 0;
+        sweep_open = false;
+        M_Er = M_Ei = 0;
+        
+        migrants.clear();
+        migrant_fit.clear();
+        max_migrants = N;
+        
+        exemplar_policy.reset();
+        schedule = Schedule();
+        observer = nullptr;
+        profiler = nullptr;
+        convergence = nullptr;
+        setBounds(-100.0, 100.0);
+        
+        dis.reset();
+        gen.seed(s);
+    }
+    
+    //Shape an instance was constructed for, used to match pooled instances
+    bool hasShape(int N_, int dim_, int max_FEs_, int M_) const {
+        return N == N_ && dim == dim_ && max_FEs == max_FEs_ && M == M_;
+    }
+    
+    //Receive run-loop events (not owned, must outlive the run); nullptr detaches
+    void setObserver(SwarmObserver* obs) {
+        observer = obs;
+    }
+    
+    //Split run time into phases (not owned, must outlive the run and be
+    //started by the caller); nullptr detaches
+    void setProfiler(PhaseProfiler* prof) {
+        profiler = prof;
+    }
+    
+    //Record best-so-far error at FE milestones (not owned, must outlive the run)
+    void setConvergenceRecorder(ConvergenceRecorder* recorder) {
+        convergence = recorder;
+    }
+    
     void setBounds(double min_val, double max_val) {
         x_min = min_val;
         x_max = max_val;
         v_max = 0.2 * (x_max - x_min);
     }
     
+    //Step 1: Generate initial swarm randomly. The initial L vectors are
+    //evaluated through the first ask()/tell() round.
     void initialize() {
-        //Step 1: Generate initial swarm randomly
         for(int n = 0; n < N; ++n) {
             Layer& layer = layers[n];
             
@@ -79,17 +472,14 @@ public:
                 double v_init = -v_max + dis(gen) * 2 * v_max;
                 
                 //Duplication: both Er and Ei start with same position/velocity
-                layer.Er.x[d] = x_init;
-                layer.Er.v[d] = v_init;
-                layer.Ei.x[d] = x_init;
-                layer.Ei.v[d] = v_init;
+                layer.Er.x[d] = static_cast<Real>(x_init);
+                layer.Er.v[d] = static_cast<Real>(v_init);
+                layer.Ei.x[d] = static_cast<Real>(x_init);
+                layer.Ei.v[d] = static_cast<Real>(v_init);
                 
-                layer.L[d] = x_init;
+                layer.L[d] = static_cast<Real>(x_init);
             }
-            
-            //Evaluate initial fitness
-            layer.L_fit = objective(layer.L);
-            FEs++;
+            layer.L_fit = std::numeric_limits<double>::infinity();
             
             //Initialize counters
             layer.Er.alpha = 0;
@@ -99,158 +489,279 @@ public:
             //Set roles
             layer.Er.role = ER;
             layer.Ei.role = EI;
-            
-            //Update global best
-            if(layer.L_fit < gbest_fit) {
-                gbest_fit = layer.L_fit;
-                gbest = layer.L;
-            }
         }
         
-        //Construct initial Q vectors
-        for(int n = 0; n < N; ++n) {
-            constructQ(n);
-        }
+        pending.assign(N, 0);
+        in_flight = 0;
+        init_remaining = N;
+        next_layer = 0;
+        sweep_open = false;
+        initialized = true;
     }
     
-    //Virtual function to construct Q - to be overridden by derived classes
-    virtual void constructQ(int layer_idx) {
-        // Default: use own L vector (basic cognitive-only PSO)
-        layers[layer_idx].Q = layers[layer_idx].L;
+    //Construct Q with the Exemplar policy
+    void constructQ(int layer_idx) {
+        ProfileScope scope(profiler, PHASE_CONSTRUCT_Q);
+        exemplar_policy.construct(*this, layer_idx);
     }
     
-    //Er-channel update: equation (5)
+    //Er-channel update (StandardUpdate: equation (5))
     void updateErChannel(int layer_idx) {
+        ProfileScope scope(profiler, PHASE_UPDATE_ER);
         Layer& layer = layers[layer_idx];
-        double w = getLinearParam(w_init, w_final, FEs, max_FEs);
-        double c = getLinearParam(c_init, c_final, FEs, max_FEs);
+        double w, c;
+        schedule.coefficients(ER, scheduleFEs(), max_FEs, w, c);
+        dispatchMove<false>(layer.Er, layer, w, c);
+    }
+    
+    //Ei-channel update (StandardUpdate: equation (6))
+    void updateEiChannel(int layer_idx) {
+        ProfileScope scope(profiler, PHASE_UPDATE_EI);
+        Layer& layer = layers[layer_idx];
+        double w, c1;
+        schedule.coefficients(EI, scheduleFEs(), max_FEs, w, c1);
+        dispatchMove<true>(layer.Ei, layer, w, c1);
+    }
+    
+    //---- Ask/tell interface ----
+    
+    typedef SwarmCandidate Candidate;
+    
+protected:
+    std::vector<Candidate> ask_buffer;  //Reused by advance()
+    
+public:
+    //Return up to max_count candidates. Cache hits and surrogate rejections are
+    //resolved internally. Fewer (possibly none) are returned when the budget is
+    //committed or every layer already has a candidate in flight.
+    std::vector<Candidate> ask(int max_count) {
+        std::vector<Candidate> out;
+        ask(max_count, out);
+        return out;
+    }
+    
+    //As ask(max_count), appending to out so callers can reuse its storage
+    void ask(int max_count, std::vector<Candidate>& out) {
+        size_t first = out.size();
+        if(!initialized) initialize();
         
-        for(int d = 0; d < dim; ++d) {
-            double r = dis(gen);
-            layer.Er.v[d] = w * layer.Er.v[d] + c * r * (layer.Q[d] - layer.Er.x[d]);
+        //Initial samples
+        if(init_remaining > 0) {
+            while(next_layer < N && static_cast<int>(out.size() - first) < max_count) {
+                int n = next_layer++;
+                Candidate c = {n, ER, true, &toObjective(n, layers[n].L), std::numeric_limits<double>::infinity()};
+                pending[n] = 1;
+                in_flight++;
+                out.push_back(c);
+            }
+            return;
+        }
+        
+        int busy_visits = 0;
+        while(static_cast<int>(out.size() - first) < max_count && FEs + in_flight < max_FEs) {
+            if(next_layer >= N) {
+                endSweep();
+                beginSweep();
+            }
             
-            //Velocity clamping
-            layer.Er.v[d] = std::max(-v_max, std::min(v_max, layer.Er.v[d]));
+            int n = next_layer++;
+            if(pending[n]) {
+                //Every layer is waiting on a result
+                if(++busy_visits >= N) break;
+                continue;
+            }
+            busy_visits = 0;
             
-            //Position update
-            layer.Er.x[d] += layer.Er.v[d];
+            Layer& layer = layers[n];
+            int action = selectAction(layer);
+            
+            //Action 0: Reconstruct Q
+            if(action == 0) {
+                layer.Er.alpha = 0;
+                layer.Ei.alpha = 0;
+                layer.beta = 0;
+                constructQ(n);
+                if(observer) observer->onReconstruction(FEs, n);
+                action = selectAction(layer);
+            }
             
-            //Boundary handling
-            if(layer.Er.x[d] < x_min) {
-                layer.Er.x[d] = x_min;
-                layer.Er.v[d] = 0;
+            //Action 1: Update Er particle, Action 2: Update Ei particle
+            Role role;
+            if(action == 1) {
+                updateErChannel(n);
+                role = ER;
+            } else if(action == 2) {
+                updateEiChannel(n);
+                role = EI;
+            } else {
+                continue;
             }
-            if(layer.Er.x[d] > x_max) {
-                layer.Er.x[d] = x_max;
-                layer.Er.v[d] = 0;
+            if(observer) observer->onSelection(FEs, n, role);
+            
+            const std::vector<double>& x = toObjective(n, (role == ER) ? layer.Er.x : layer.Ei.x);
+            if(screenedOut(x, layer.L_fit)) {
+                applyResult(n, role, std::numeric_limits<double>::infinity());
+                continue;
             }
+            
+            double fit;
+            if(cache && cache->lookup(x, layer.L_fit, fit)) {
+                FEs++;
+                applyResult(n, role, fit);
+                recordConvergence();
+                continue;
+            }
+            
+            Candidate c = {n, role, false, &x, layer.L_fit};
+            pending[n] = 1;
+            in_flight++;
+            out.push_back(c);
         }
     }
     
-    //Ei-channel update: equation (6)
-    void updateEiChannel(int layer_idx) {
-        Layer& layer = layers[layer_idx];
-        double w = getLinearParam(w_init, w_final, FEs, max_FEs);
-        double c1 = getLinearParam(c1_init, c1_final, FEs, max_FEs);
+    //Report the fitness of an asked candidate; results may arrive in any order.
+    //exact = false marks fit as a lower bound from an aborted bounded evaluation.
+    void tell(const Candidate& c, double fit, bool exact = true) {
+        true_evaluations++;
         
-        for(int d = 0; d < dim; ++d) {
-            double r1 = dis(gen);
-            layer.Ei.v[d] = w * layer.Ei.v[d] + 
-                           c1 * r1 * ((layer.Q[d] + gbest[d]) / 2.0 - layer.Ei.x[d]);
-            
-            //Velocity clamping
-            layer.Ei.v[d] = std::max(-v_max, std::min(v_max, layer.Ei.v[d]));
-            
-            //Position update
-            layer.Ei.x[d] += layer.Ei.v[d];
-            
-            //Boundary handling
-            if(layer.Ei.x[d] < x_min) {
-                layer.Ei.x[d] = x_min;
-                layer.Ei.v[d] = 0;
-            }
-            if(layer.Ei.x[d] > x_max) {
-                layer.Ei.x[d] = x_max;
-                layer.Ei.v[d] = 0;
+        if(cache) {
+            cache->store(*c.x, fit, exact);
+        }
+        if(surrogate) {
+            //Lower bounds from aborted evaluations only make the model more conservative
+            surrogate->add(*c.x, fit);
+        }
+        
+        resolveCandidate(c.layer, c.role, c.initial, fit);
+    }
+    
+    //Report an asked candidate as failed (e.g. timed out): charged to the
+    //budget and counted as an R&P failure, but kept out of cache and surrogate
+    void tellFailure(const Candidate& c) {
+        resolveCandidate(c.layer, c.role, c.initial, std::numeric_limits<double>::infinity());
+    }
+    
+    //Batch tell. A fit at or above the candidate's bound counts as a lower
+    //bound when a bounded objective is set, as in advance(); callers using
+    //their own bounded evaluator pass exact per candidate instead.
+    void tell(const std::vector<Candidate>& candidates, const std::vector<double>& fits) {
+        for(size_t i = 0; i < candidates.size(); ++i) {
+            tell(candidates[i], fits[i], !bounded_objective || fits[i] < candidates[i].bound);
+        }
+    }
+    
+    void tell(const std::vector<Candidate>& candidates, const std::vector<double>& fits,
+              const std::vector<char>& exact) {
+        for(size_t i = 0; i < candidates.size(); ++i) {
+            tell(candidates[i], fits[i], exact[i] != 0);
+        }
+    }
+    
+    //True once the budget is used up and no candidate is in flight
+    bool done() const {
+        return initialized && init_remaining == 0 && in_flight == 0 && FEs >= max_FEs;
+    }
+    
+    //Evaluate with the objective until FEs has advanced by at least fes or
+    //the run is done. Returns false once the run is done.
+    bool advance(int fes) {
+        if(!initialized) initialize();
+        int target = FEs + fes;
+        
+        while(!done() && FEs < target) {
+            ask_buffer.clear();
+            ask(1, ask_buffer);
+            for(const Candidate& c : ask_buffer) {
+                double fit = evaluate(*c.x, c.bound);
+                tell(c, fit, !bounded_objective || fit < c.bound);
             }
         }
+        return !done();
+    }
+    
+    //Close the last sweep of a run driven through ask/tell or advance()
+    void finish() {
+        endSweep();
+        if(observer) observer->onRunEnd(FEs, gbest_fit);
     }
     
     void run() {
+        TraceSpan span("run", "optimizer");
         initialize();
-        
-        while(FEs < max_FEs) {
-            int M_Er, M_Ei;
-            abs.calculateThresholds(FEs, max_FEs, M_Er, M_Ei);
-            
-            for(int n = 0; n < N; ++n) {
-                if(FEs >= max_FEs) break;
-                
-                Layer& layer = layers[n];
-                int action = abs.selectParticle(layer, M_Er, M_Ei);
-                
-                //Action 0: Reconstruct Q
-                if(action == 0) {
-                    layer.Er.alpha = 0;
-                    layer.Ei.alpha = 0;
-                    layer.beta = 0;
-                    constructQ(n);
-                    action = abs.selectParticle(layer, M_Er, M_Ei);
-                }
-                
-                //Action 1: Update Er particle
-                if(action == 1) {
-                    updateErChannel(n);
-                    double fit = objective(layer.Er.x);
-                    FEs++;
-                    
-                    //R&P box for Er particle
-                    if(fit >= layer.L_fit) {
-                        layer.Er.alpha = layer.Er.alpha + 1;
-                    } else {
-                        layer.Er.alpha = 0;
-                        layer.beta = layer.beta + 1;
-                        layer.L = layer.Er.x;
-                        layer.L_fit = fit;
-                        
-                        if(fit < gbest_fit) {
-                            gbest_fit = fit;
-                            gbest = layer.L;
-                        }
-                    }
-                }
-                //Action 2: Update Ei particle
-                else if(action == 2) {
-                    updateEiChannel(n);
-                    double fit = objective(layer.Ei.x);
-                    FEs++;
-                    
-                    //R&P box for Ei particle
-                    if(fit >= layer.L_fit) {
-                        layer.Ei.alpha = layer.Ei.alpha + 1;
-                    } else {
-                        //If only L is updated, keep alpha unchanged
-                        //If G is updated, reset alpha to 0
-                        layer.L = layer.Ei.x;
-                        layer.L_fit = fit;
-                        
-                        if(fit < gbest_fit) {
-                            gbest_fit = fit;
-                            gbest = layer.L;
-                            layer.Ei.alpha = 0;  //Reset when G is updated
-                        }
-                        //else: alpha unchanged (reward one more time)
-                    }
-                }
-            }
-            
-            //Progress output every 100*N evaluations
-            if(FEs % (100 * N) == 0) {
-                std::cout << "FEs: " << FEs << " Best Fit: " << gbest_fit << std::endl;
+        advance(max_FEs);
+        finish();
+    }
+    
+    //Charge evaluations made outside this optimizer (e.g. by other sub-swarms
+    //sharing one budget) to FEs, advancing the schedules and the budget
+    void consumeBudget(int fes) {
+        FEs += fes;
+        recordConvergence();
+    }
+    
+    //Re-evaluate every L vector and gbest after the objective has changed,
+    //e.g. a new context vector. Requires no candidate in flight; charged to FEs.
+    void rescore() {
+        if(cache) cache->clear();
+        gbest_fit = std::numeric_limits<double>::infinity();
+        for(int n = 0; n < N; ++n) {
+            Layer& layer = layers[n];
+            layer.L_fit = evaluate(toObjective(n, layer.L), std::numeric_limits<double>::infinity());
+            FEs++;
+            true_evaluations++;
+            if(layer.L_fit < gbest_fit) {
+                gbest_fit = layer.L_fit;
+                gbest = layer.L;
             }
         }
+        recordConvergence();
+    }
+    
+    //---- Migration (island models) ----
+    
+    //Add an external solution to the exemplar pool used by constructQ.
+    //When the pool is full the worst migrant is replaced if x is better.
+    void acceptMigrant(const std::vector<double>& x, double fit) {
+        if(static_cast<int>(migrants.size()) < max_migrants) {
+            migrants.push_back(std::vector<Real>(x.begin(), x.end()));
+            migrant_fit.push_back(fit);
+        } else if(max_migrants > 0) {
+            size_t worst = std::max_element(migrant_fit.begin(), migrant_fit.end()) - migrant_fit.begin();
+            if(fit >= migrant_fit[worst]) return;
+            migrants[worst].assign(x.begin(), x.end());
+            migrant_fit[worst] = fit;
+        }
+        
+        if(fit < gbest_fit) {
+            gbest_fit = fit;
+            gbest.assign(x.begin(), x.end());
+            notifyImprovement();
+        }
+    }
+    
+    void setMaxMigrants(int max_count) { max_migrants = max_count; }
+    
+    //The k best L vectors of this swarm, best first
+    void getElites(int k, std::vector<std::vector<double>>& xs, std::vector<double>& fits) const {
+        std::vector<int> order(N);
+        for(int n = 0; n < N; ++n) order[n] = n;
+        k = std::min(k, N);
+        std::partial_sort(order.begin(), order.begin() + k, order.end(),
+                          [this](int a, int b) { return layers[a].L_fit < layers[b].L_fit; });
+        xs.clear();
+        fits.clear();
+        for(int i = 0; i < k; ++i) {
+            xs.push_back(std::vector<double>(layers[order[i]].L.begin(), layers[order[i]].L.end()));
+            fits.push_back(layers[order[i]].L_fit);
+        }
     }
     
     double getGBestFitness() { return gbest_fit; }
-    std::vector<double> getGBest() { return gbest; }
-};
\ No newline at end of file
+    std::vector<double> getGBest() { return std::vector<double>(gbest.begin(), gbest.end()); }
+};
+
+//Cognitive-only default variant
+template<class Real>
+using CHxPSO_ABS_T = CHxPSO<Real, OwnBestExemplar>;
+
+typedef CHxPSO_ABS_T<double> CHxPSO_ABS;
@@ -0,0 +1,95 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <ostream>
+#include <iomanip>
+#include <cmath>
+#include <limits>
+
+//Best-so-far error of one run at fixed FE milestones. The swarm calls
+//update() after every charged evaluation; it only compares FEs against the
+//next milestone and writes into a row owned by a ConvergenceTable, so a run
+//neither allocates nor does I/O while recording.
+class ConvergenceRecorder {
+    const long long* milestones = nullptr;
+    int count = 0;
+    double* row = nullptr;
+    double optimum = 0.0;
+    int next = 0;
+    long long next_FEs = std::numeric_limits<long long>::max();
+
+public:
+    void attach(const long long* milestones_, int count_, double* row_, double optimum_) {
+        milestones = milestones_;
+        count = count_;
+        row = row_;
+        optimum = optimum_;
+        next = 0;
+        next_FEs = count > 0 ? milestones[0] : std::numeric_limits<long long>::max();
+    }
+
+    //Record best_fit at every milestone reached by FEs
+    void update(long long FEs, double best_fit) {
+        if(FEs < next_FEs) return;
+        while(next < count && FEs >= milestones[next]) {
+            row[next++] = best_fit - optimum;
+        }
+        next_FEs = next < count ? milestones[next] : std::numeric_limits<long long>::max();
+    }
+};
+
+//Convergence curves of the runs of one (function, dim) cell: runs x milestones
+//errors, preallocated, dumped once with write(). Milestones not reached
+//(e.g. a run cut short) stay NaN.
+class ConvergenceTable {
+    std::vector<double> ratios;
+    std::vector<long long> milestones;
+    int runs;
+    std::vector<double> errors;         //Row per run
+    std::vector<ConvergenceRecorder> recorders;
+
+public:
+    //Milestones at ratio * max_FEs for each ratio in (0, 1]
+    ConvergenceTable(const std::vector<double>& ratios_, int max_FEs, int runs_, double optimum)
+        : ratios(ratios_), runs(runs_) {
+        for(double r : ratios) {
+            long long m = std::llround(r * max_FEs);
+            milestones.push_back(m > 0 ? m : 1);
+        }
+        int K = static_cast<int>(milestones.size());
+        errors.assign(static_cast<size_t>(runs) * K, std::numeric_limits<double>::quiet_NaN());
+        recorders.resize(runs);
+        for(int r = 0; r < runs; ++r) {
+            recorders[r].attach(milestones.data(), K, errors.data() + static_cast<size_t>(r) * K, optimum);
+        }
+    }
+
+    ConvergenceTable(const ConvergenceTable&) = delete;
+    ConvergenceTable& operator=(const ConvergenceTable&) = delete;
+
+    //Milestones of the CEC 2017 technical report: 0.01, 0.02, 0.03, 0.05, 0.1, ..., 1.0
+    static std::vector<double> cec2017Ratios() {
+        return {0.01, 0.02, 0.03, 0.05, 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.0};
+    }
+
+    ConvergenceRecorder& recorder(int run) { return recorders[run]; }
+
+    int size() const { return static_cast<int>(milestones.size()); }
+    double error(int run, int k) const { return errors[static_cast<size_t>(run) * milestones.size() + k]; }
+    const double* curve(int run) const { return errors.data() + static_cast<size_t>(run) * milestones.size(); }
+
+    //One line per milestone: ratio, FEs, then the error of every run
+    void write(std::ostream& out, const std::string& label) const {
+        out << "\n" << label << '\n';
+        out << "ratio\tFEs";
+        for(int r = 0; r < runs; ++r) out << "\tRun" << (r + 1);
+        out << '\n';
+        for(int k = 0; k < size(); ++k) {
+            out << std::fixed << std::setprecision(2) << ratios[k] << '\t' << milestones[k];
+            out << std::scientific << std::setprecision(6);
+            for(int r = 0; r < runs; ++r) out << '\t' << error(r, k);
+            out << '\n';
+        }
+        out << std::defaultfloat;
+    }
+};
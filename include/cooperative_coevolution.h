@@ -0,0 +1,225 @@
+#pragma once
+#include "chxpso_abs.h"
+#include <vector>
+#include <memory>
+#include <functional>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <limits>
+
+enum GroupingMethod { RANDOM_GROUPING, DIFFERENTIAL_GROUPING };
+
+//Cooperative coevolution for large-scale problems: the variables are split
+//into groups and each group is optimized by its own sub-swarm of dimension
+//|group|, evaluated inside a shared context vector holding the best known
+//values of all other variables. All sub-swarms share one FEs budget, so
+//their ABS schedules follow global progress. After one round-robin pass,
+//cycles go to the group with the largest recent contribution (CBCC).
+//Differential grouping may use at most half of max_FEs; variables it has
+//not placed by then are grouped at random.
+template<class Swarm>
+class CooperativeCoevolution {
+    typedef std::function<double(const std::vector<double>&)> Objective;
+
+    int N, dim, max_FEs, M;
+    int group_size;             //Random grouping size, also used to pack separable variables
+    GroupingMethod method;
+    int cycle_FEs;              //FEs given to a sub-swarm per cycle
+
+    Objective objective;
+    double lb = -100.0, ub = 100.0;
+    long long FEs = 0;
+
+    std::vector<std::vector<int>> groups;
+    std::vector<std::unique_ptr<Swarm>> swarms;
+    std::vector<std::vector<double>> scratch;   //Per group: full-dimensional evaluation buffer
+    std::vector<double> contribution;           //Recent context improvement per FE
+    std::vector<long long> context_version;     //Context version each sub-swarm was scored with
+
+    std::vector<double> context;
+    double context_fit = std::numeric_limits<double>::infinity();
+    long long version = 0;
+
+    std::vector<double> cycle_best;             //Best full vector evaluated in the current cycle
+    double cycle_best_fit = std::numeric_limits<double>::infinity();
+
+    std::mt19937 gen;
+
+    double evaluateFull(const std::vector<double>& x) {
+        FEs++;
+        return objective(x);
+    }
+
+    void randomGrouping(const std::vector<int>& vars) {
+        std::vector<int> perm = vars;
+        std::shuffle(perm.begin(), perm.end(), gen);
+        for(size_t start = 0; start < perm.size(); start += group_size) {
+            size_t end = std::min(perm.size(), start + group_size);
+            groups.push_back(std::vector<int>(perm.begin() + start, perm.begin() + end));
+        }
+    }
+
+    //Differential grouping (Omidvar et al., 2014): i and j interact if the
+    //effect of moving x_i changes when x_j is moved. x_i moves to the centre
+    //and x_j to the upper bound so symmetric terms such as x_i^2 still register.
+    void differentialGrouping() {
+        std::vector<int> remaining(dim);
+        std::iota(remaining.begin(), remaining.end(), 0);
+        std::vector<int> separable;
+        const long long limit = max_FEs / 2;
+
+        const double mid = 0.5 * (lb + ub);
+        std::vector<double> p1(dim), p2(dim);
+        while(!remaining.empty() && FEs + 2 <= limit) {
+            int i = remaining.front();
+            remaining.erase(remaining.begin());
+            std::vector<int> group(1, i);
+
+            std::fill(p1.begin(), p1.end(), lb);
+            p2 = p1;
+            p2[i] = mid;
+            double f1 = evaluateFull(p1);
+            double delta1 = f1 - evaluateFull(p2);
+            double eps = 1e-3 + 1e-10 * std::fabs(f1);  //Tolerate rounding of large values
+
+            for(size_t k = 0; k < remaining.size() && FEs + 2 <= limit;) {
+                int j = remaining[k];
+                p1[j] = ub;
+                p2[j] = ub;
+                double delta2 = evaluateFull(p1) - evaluateFull(p2);
+                p1[j] = lb;
+                p2[j] = lb;
+
+                if(std::fabs(delta1 - delta2) > eps) {
+                    group.push_back(j);
+                    remaining.erase(remaining.begin() + k);
+                } else {
+                    ++k;
+                }
+            }
+
+            if(group.size() == 1) {
+                separable.push_back(i);
+            } else {
+                groups.push_back(group);
+            }
+        }
+
+        //Pack the separable and the untested variables into groups of group_size
+        separable.insert(separable.end(), remaining.begin(), remaining.end());
+        randomGrouping(separable);
+    }
+
+    //Run one cycle of sub-swarm g inside the current context. The context
+    //takes the best vector actually evaluated in this cycle, so a sub-swarm
+    //left with stale scores cannot write a wrong fitness into it.
+    void runCycle(int g) {
+        Swarm& swarm = *swarms[g];
+        long long FEs_before = FEs;
+        double before = context_fit;
+        cycle_best_fit = std::numeric_limits<double>::infinity();
+
+        if(context_version[g] < 0) {
+            swarm.initialize();
+        } else if(context_version[g] != version && max_FEs - FEs >= 2LL * N) {
+            swarm.rescore();    //Skipped when it would leave less than N FEs to search
+        }
+        int budget = static_cast<int>(std::min<long long>(cycle_FEs, max_FEs - FEs));
+        if(budget > 0) swarm.advance(budget);
+        context_version[g] = version;
+
+        if(cycle_best_fit < context_fit) {
+            context = cycle_best;
+            context_fit = cycle_best_fit;
+            version++;
+            context_version[g] = version;
+        }
+
+        //Keep every other sub-swarm's schedule on the shared budget
+        int used = static_cast<int>(FEs - FEs_before);
+        for(size_t h = 0; h < swarms.size(); ++h) {
+            if(static_cast<int>(h) != g) swarms[h]->consumeBudget(used);
+        }
+
+        double gain = (before - context_fit) / std::max(used, 1);
+        contribution[g] = 0.5 * (contribution[g] + gain);
+    }
+
+public:
+    CooperativeCoevolution(int N_, int dim_, int max_FEs_, int M_,
+                           GroupingMethod method_ = RANDOM_GROUPING, int group_size_ = 50, int cycle_FEs_ = 0)
+        : N(N_), dim(dim_), max_FEs(max_FEs_), M(M_), group_size(group_size_ > 0 ? group_size_ : 1),
+          method(method_), cycle_FEs(cycle_FEs_ > 0 ? cycle_FEs_ : 100 * N_) {
+        gen.seed(std::random_device{}());
+    }
+
+    void setObjective(Objective obj) { objective = obj; }
+
+    void setBounds(double min_val, double max_val) {
+        lb = min_val;
+        ub = max_val;
+    }
+
+    void run() {
+        FEs = 0;
+        groups.clear();
+        if(method == DIFFERENTIAL_GROUPING) {
+            differentialGrouping();
+        } else {
+            std::vector<int> vars(dim);
+            std::iota(vars.begin(), vars.end(), 0);
+            randomGrouping(vars);
+        }
+
+        //Initial context vector
+        std::uniform_real_distribution<double> dis(lb, ub);
+        context.resize(dim);
+        for(int d = 0; d < dim; ++d) context[d] = dis(gen);
+        context_fit = evaluateFull(context);
+
+        int G = static_cast<int>(groups.size());
+        swarms.clear();
+        scratch.assign(G, context);
+        contribution.assign(G, 0.0);
+        context_version.assign(G, -1);
+        for(int g = 0; g < G; ++g) {
+            int group_dim = static_cast<int>(groups[g].size());
+            swarms.emplace_back(new Swarm(N, group_dim, max_FEs, M));
+            swarms[g]->setBounds(lb, ub);
+            swarms[g]->consumeBudget(static_cast<int>(FEs));  //Grouping and context evaluations
+
+            swarms[g]->setObjective([this, g](const std::vector<double>& x) {
+                std::vector<double>& full = scratch[g];
+                full = context;
+                const std::vector<int>& vars = groups[g];
+                for(size_t k = 0; k < vars.size(); ++k) full[vars[k]] = x[k];
+                double fit = evaluateFull(full);
+                if(fit < cycle_best_fit) {
+                    cycle_best_fit = fit;
+                    cycle_best = full;
+                }
+                return fit;
+            });
+        }
+
+        //One round-robin pass, then contribution-based selection
+        for(int g = 0; g < G && FEs < max_FEs; ++g) {
+            runCycle(g);
+        }
+        while(FEs < max_FEs) {
+            int best_g = static_cast<int>(std::max_element(contribution.begin(), contribution.end()) - contribution.begin());
+            //Stagnant groups still get an occasional cycle
+            if(contribution[best_g] <= 0.0 || std::uniform_real_distribution<double>(0.0, 1.0)(gen) < 0.05) {
+                best_g = static_cast<int>(gen() % G);
+            }
+            runCycle(best_g);
+        }
+    }
+
+    const std::vector<std::vector<int>>& getGroups() const { return groups; }
+    long long getFEs() const { return FEs; }
+    double getGBestFitness() { return context_fit; }
+    std::vector<double> getGBest() { return context; }
+};
@@ -0,0 +1,122 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+//Bounded position -> fitness cache placed in front of the objective.
+//Keys are the exact bit patterns of the coordinates (quantum == 0) or the
+//coordinates rounded to a user-supplied grid (quantum > 0).
+class EvaluationCache {
+public:
+    struct Stats {
+        long long hits = 0;
+        long long misses = 0;
+        long long evictions = 0;
+    };
+
+private:
+    typedef std::vector<int64_t> Key;
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            uint64_t h = 1469598103934665603ULL;
+            for(int64_t k : key) {
+                h ^= static_cast<uint64_t>(k);
+                h *= 1099511628211ULL;
+                h ^= h >> 29;
+            }
+            return static_cast<size_t>(h);
+        }
+    };
+
+    struct Entry {
+        double value;
+        bool exact;     //false: value is only a lower bound from an aborted bounded evaluation
+    };
+
+    typedef std::unordered_map<Key, Entry, KeyHash> Table;
+
+    size_t capacity;
+    double quantum;
+    Table table;
+    std::vector<Table::iterator> fifo;  //Insertion order, used as a ring for eviction
+    size_t fifo_head = 0;
+    Stats stats;
+
+    void makeKey(const std::vector<double>& x, Key& key) const {
+        key.resize(x.size());
+        for(size_t d = 0; d < x.size(); ++d) {
+            if(quantum > 0.0) {
+                key[d] = static_cast<int64_t>(std::llround(x[d] / quantum));
+            } else {
+                double xd = x[d] + 0.0;  //Fold -0.0 onto +0.0
+                std::memcpy(&key[d], &xd, sizeof(double));
+            }
+        }
+    }
+
+public:
+    EvaluationCache(size_t capacity_, double quantum_ = 0.0)
+        : capacity(capacity_ > 0 ? capacity_ : 1), quantum(quantum_) {
+        //No rehash can happen below capacity, so the stored iterators stay valid
+        table.reserve(capacity);
+        fifo.reserve(capacity);
+    }
+
+    //Returns true if x is answered by the cache for a comparison against bound:
+    //either an exact value, or a lower bound that already rejects x
+    bool lookup(const std::vector<double>& x, double bound, double& value) {
+        Key key;
+        makeKey(x, key);
+        Table::const_iterator it = table.find(key);
+        if(it != table.end() && (it->second.exact || it->second.value >= bound)) {
+            value = it->second.value;
+            stats.hits++;
+            return true;
+        }
+        stats.misses++;
+        return false;
+    }
+
+    void store(const std::vector<double>& x, double value, bool exact) {
+        Key key;
+        makeKey(x, key);
+        Table::iterator it = table.find(key);
+        if(it != table.end()) {
+            //Never replace an exact value by a lower bound
+            if(exact || !it->second.exact) {
+                it->second.value = exact ? value : std::max(value, it->second.value);
+                it->second.exact = exact;
+            }
+            return;
+        }
+
+        if(table.size() >= capacity) {
+            table.erase(fifo[fifo_head]);
+            stats.evictions++;
+            it = table.emplace(key, Entry{value, exact}).first;
+            fifo[fifo_head] = it;
+            fifo_head = (fifo_head + 1) % capacity;
+        } else {
+            it = table.emplace(key, Entry{value, exact}).first;
+            fifo.push_back(it);
+        }
+    }
+
+    void clear() {
+        table.clear();
+        fifo.clear();
+        fifo_head = 0;
+        stats = Stats();
+    }
+
+    size_t size() const { return table.size(); }
+    const Stats& getStats() const { return stats; }
+    double hitRate() const {
+        long long total = stats.hits + stats.misses;
+        return total > 0 ? static_cast<double>(stats.hits) / total : 0.0;
+    }
+};
@@ -0,0 +1,147 @@
+#pragma once
+#include "chxpso_abs.h"
+#include "trace.h"
+#include <vector>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <random>
+#include <limits>
+
+enum MigrationTopology { RING, STAR, RANDOM_PAIRS };
+
+//Islands that island i of K sends to at a migration
+inline std::vector<int> migrationTargets(MigrationTopology topology, int i, int K, std::mt19937& gen) {
+    std::vector<int> out;
+    if(K < 2) return out;
+    switch(topology) {
+    case RING:
+        out.push_back((i + 1) % K);
+        break;
+    case STAR:
+        //Island 0 is the hub
+        if(i == 0) {
+            for(int j = 1; j < K; ++j) out.push_back(j);
+        } else {
+            out.push_back(0);
+        }
+        break;
+    case RANDOM_PAIRS: {
+        int j = static_cast<int>(gen() % (K - 1));
+        out.push_back(j >= i ? j + 1 : j);
+        break;
+    }
+    }
+    return out;
+}
+
+//Island model: K independent swarms (CHCLPSO_ABS, CHpPSO_ABS, ...) on
+//separate threads, each with its own ABS schedule and budget. Every
+//migration_interval FEs an island sends its best L vectors to its
+//neighbours and moves received migrants into its exemplar pool.
+//Islands only meet at their mailboxes, never on the evaluation path.
+template<class Swarm>
+class IslandModel {
+    typedef std::function<double(const std::vector<double>&)> Objective;
+
+    struct Mailbox {
+        std::mutex mtx;
+        std::vector<std::vector<double>> xs;
+        std::vector<double> fits;
+    };
+
+    int K;
+    int migration_interval;     //FEs between migrations (per island)
+    int num_migrants;           //L vectors sent per migration
+    MigrationTopology topology;
+
+    std::vector<std::unique_ptr<Swarm>> islands;
+    std::vector<std::unique_ptr<Mailbox>> mailboxes;
+
+    std::vector<double> best;
+    double best_fit = std::numeric_limits<double>::infinity();
+
+    void migrate(int i, std::mt19937& gen) {
+        TraceSpan span("migrate", "migration");
+        Swarm& swarm = *islands[i];
+
+        std::vector<std::vector<double>> xs;
+        std::vector<double> fits;
+        swarm.getElites(num_migrants, xs, fits);
+        for(int j : migrationTargets(topology, i, K, gen)) {
+            Mailbox& box = *mailboxes[j];
+            std::lock_guard<std::mutex> lock(box.mtx);
+            box.xs.insert(box.xs.end(), xs.begin(), xs.end());
+            box.fits.insert(box.fits.end(), fits.begin(), fits.end());
+        }
+
+        Mailbox& own = *mailboxes[i];
+        {
+            std::lock_guard<std::mutex> lock(own.mtx);
+            xs.swap(own.xs);
+            fits.swap(own.fits);
+            own.xs.clear();
+            own.fits.clear();
+        }
+        for(size_t m = 0; m < xs.size(); ++m) {
+            swarm.acceptMigrant(xs[m], fits[m]);
+        }
+    }
+
+    void runIsland(int i) {
+        TraceLog::nameThread("island " + std::to_string(i));
+        TraceSpan span("island run", "optimizer");
+        std::mt19937 gen(std::random_device{}());
+        Swarm& swarm = *islands[i];
+        swarm.initialize();
+        while(swarm.advance(migration_interval)) {
+            migrate(i, gen);
+        }
+    }
+
+public:
+    IslandModel(int K_, int N, int dim, int max_FEs, int M,
+                MigrationTopology topology_ = RING, int migration_interval_ = 1000, int num_migrants_ = 1)
+        : K(K_), migration_interval(migration_interval_), num_migrants(num_migrants_), topology(topology_) {
+        for(int i = 0; i < K; ++i) {
+            islands.emplace_back(new Swarm(N, dim, max_FEs, M));
+            mailboxes.emplace_back(new Mailbox());
+        }
+    }
+
+    //One objective shared by all islands; it must be safe to call concurrently
+    void setObjective(Objective obj) {
+        for(auto& island : islands) island->setObjective(obj);
+    }
+
+    //A separate objective instance per island
+    void setObjectiveFactory(std::function<Objective(int)> factory) {
+        for(int i = 0; i < K; ++i) islands[i]->setObjective(factory(i));
+    }
+
+    void setBounds(double min_val, double max_val) {
+        for(auto& island : islands) island->setBounds(min_val, max_val);
+    }
+
+    void run() {
+        std::vector<std::thread> threads;
+        for(int i = 0; i < K; ++i) {
+            threads.emplace_back(&IslandModel::runIsland, this, i);
+        }
+        for(std::thread& t : threads) {
+            t.join();
+        }
+
+        for(auto& island : islands) {
+            if(island->getGBestFitness() < best_fit) {
+                best_fit = island->getGBestFitness();
+                best = island->getGBest();
+            }
+        }
+    }
+
+    Swarm& island(int i) { return *islands[i]; }
+    double getGBestFitness() { return best_fit; }
+    std::vector<double> getGBest() { return best; }
+};
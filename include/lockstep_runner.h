@@ -0,0 +1,132 @@
+#pragma once
+#include "chxpso_abs.h"
+#include "swarm_pool.h"
+#include <vector>
+#include <memory>
+#include <functional>
+#include <algorithm>
+
+//Batched objective: evaluate the m points of block X into f
+typedef std::function<void(const double* X, int m, double* f)> BatchObjective;
+
+//Layout of the candidate block handed to a BatchObjective
+enum BatchLayout {
+    ROW_MAJOR,      //m x dim, one candidate per row (CEC test_func convention)
+    DIM_MAJOR       //dim x m, one coordinate per row (SIMD-across-candidates kernels)
+};
+
+//Advances R independent runs of the same (function, dim) cell in lockstep.
+//Every run keeps its own generator and swarm state and takes exactly the
+//ask(1)/tell steps of a solo run(), so with the same seed each run ends
+//bit-identical to running that seed alone. At each step the candidates of
+//all runs go to the objective in one batched call, so per-call setup and
+//the function's data (shift vectors, rotation matrices) are touched once
+//per step for all R candidates.
+template<class Swarm>
+class LockstepRunner {
+    int R, dim;
+    std::vector<Swarm*> runs;
+    std::vector<std::unique_ptr<Swarm>> owned;
+    SwarmPool<Swarm>* pool = nullptr;               //Source of runs, if pooled
+    BatchObjective batch;
+    BatchLayout layout = ROW_MAJOR;
+    PhaseProfiler* profiler = nullptr;
+
+    std::vector<double> X;                          //R x dim candidate block
+    std::vector<double> F;
+    std::vector<int> owner;                         //Run of each row of X
+    std::vector<typename Swarm::Candidate> pending; //Candidate of each row of X
+
+public:
+    LockstepRunner(int R_, int N, int dim_, int max_FEs, int M, const std::vector<unsigned int>& seeds)
+        : R(R_), dim(dim_) {
+        for(int r = 0; r < R; ++r) {
+            owned.emplace_back(new Swarm(N, dim, max_FEs, M));
+            runs.push_back(owned.back().get());
+            if(r < static_cast<int>(seeds.size())) runs[r]->seed(seeds[r]);
+        }
+        X.resize(static_cast<size_t>(R) * dim);
+        F.resize(R);
+        owner.reserve(R);
+        pending.reserve(R);
+    }
+    
+    //Runs taken from pool (one per seed), returned to it on destruction
+    LockstepRunner(SwarmPool<Swarm>& pool_, int N, int dim_, int max_FEs, int M, const std::vector<unsigned int>& seeds)
+        : R(static_cast<int>(seeds.size())), dim(dim_), pool(&pool_) {
+        for(int r = 0; r < R; ++r) {
+            runs.push_back(&pool->acquire(N, dim, max_FEs, M, seeds[r]));
+        }
+        X.resize(static_cast<size_t>(R) * dim);
+        F.resize(R);
+        owner.reserve(R);
+        pending.reserve(R);
+    }
+    
+    ~LockstepRunner() {
+        if(pool) {
+            for(Swarm* run : runs) pool->release(*run);
+        }
+    }
+    
+    LockstepRunner(const LockstepRunner&) = delete;
+    LockstepRunner& operator=(const LockstepRunner&) = delete;
+
+    void setBatchObjective(BatchObjective obj, BatchLayout layout_ = ROW_MAJOR) {
+        batch = obj;
+        layout = layout_;
+    }
+
+    //Profile every run and the batched evaluations with prof (not owned)
+    void setProfiler(PhaseProfiler* prof) {
+        profiler = prof;
+        for(Swarm* run : runs) run->setProfiler(prof);
+    }
+
+    void setBounds(double min_val, double max_val) {
+        for(Swarm* run : runs) run->setBounds(min_val, max_val);
+    }
+
+    void run() {
+        TraceSpan span("lockstep run", "optimizer");
+        for(Swarm* run : runs) run->initialize();
+
+        for(;;) {
+            owner.clear();
+            pending.clear();
+            for(int r = 0; r < R; ++r) {
+                if(runs[r]->done()) continue;
+                //ask() appends in place, so a step allocates nothing once pending has grown
+                size_t before = pending.size();
+                runs[r]->ask(1, pending);
+                if(pending.size() > before) owner.push_back(r);
+            }
+            if(owner.empty()) break;
+
+            int m = static_cast<int>(owner.size());
+            for(int k = 0; k < m; ++k) {
+                const std::vector<double>& x = *pending[k].x;
+                if(layout == ROW_MAJOR) {
+                    std::copy(x.begin(), x.end(), X.begin() + static_cast<size_t>(k) * dim);
+                } else {
+                    for(int d = 0; d < dim; ++d) X[static_cast<size_t>(d) * m + k] = x[d];
+                }
+            }
+
+            {
+                ProfileScope scope(profiler, PHASE_EVALUATE);
+                TraceSpan trace("evaluate batch", "objective", TRACE_EVALUATIONS);
+                batch(X.data(), m, F.data());
+            }
+
+            for(size_t k = 0; k < owner.size(); ++k) {
+                runs[owner[k]]->tell(pending[k], F[k]);
+            }
+        }
+
+        for(Swarm* run : runs) run->finish();
+    }
+
+    int size() const { return R; }
+    Swarm& getRun(int r) { return *runs[r]; }
+};
@@ -0,0 +1,449 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+
+//Header-only expression DSL for separable and partially separable objectives.
+//An objective is written as an expression over the coordinate placeholders
+//x (z_i) and x_next (z_{i+1}), the index i and the dimension D, reduced with
+//sum(). Expression templates inline the whole term into a single loop per
+//sum(), with no calls through std::function or virtual dispatch:
+//
+//    using namespace dsl;
+//    auto f_rastrigin  = compile(sum(x*x - 10*cos(2*pi*x)) + 10*D);
+//    auto f_rosenbrock = compile(sum(100*sq(x_next - sq(x)) + sq(x - 1)));
+//    auto f_ellips     = compile(sum(pow(1e6, i/(D - 1)) * sq(x)))
+//                            .shifted(o).rotated(M);    //CEC-style z = M(x - o)
+//
+//A compiled objective is called like the basic benchmarks (f(x)) and also
+//provides bounded(x, bound) for bounded evaluation. For single-sum
+//objectives that are increasing in the sum and whose terms have a finite
+//lower bound (found by interval analysis, e.g. sq(.) >= 0, cos(.) >= -1),
+//bounded() stops once the result is provably >= bound; otherwise it is
+//the full evaluation. Both paths accumulate in the same order, so bounded()
+//is exact whenever it returns a value below bound. Monotonicity is decided at
+//the evaluated dimension, so D-dependent factors such as (2 - D) get their
+//actual sign.
+//
+//A compiled objective is not thread-safe: evaluation writes its shift and
+//rotation scratch buffers. Give each thread its own copy.
+namespace dsl {
+
+const double pi = 3.14159265358979323846;
+
+//---- Interval arithmetic for term lower bounds ----
+struct Interval {
+    double lo, hi;
+};
+
+inline Interval whole() {
+    return Interval{-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()};
+}
+
+inline double mulBound(double a, double b) {
+    //0 * inf is 0 here: a zero factor bounds the product exactly
+    if(a == 0.0 || b == 0.0) return 0.0;
+    return a * b;
+}
+
+inline Interval imul(Interval a, Interval b) {
+    double p[4] = {mulBound(a.lo, b.lo), mulBound(a.lo, b.hi), mulBound(a.hi, b.lo), mulBound(a.hi, b.hi)};
+    return Interval{*std::min_element(p, p + 4), *std::max_element(p, p + 4)};
+}
+
+inline Interval isq(Interval a) {
+    if(a.lo >= 0.0) return Interval{a.lo * a.lo, a.hi * a.hi};
+    if(a.hi <= 0.0) return Interval{a.hi * a.hi, a.lo * a.lo};
+    return Interval{0.0, std::max(a.lo * a.lo, a.hi * a.hi)};
+}
+
+//Monotonicity of a scalar expression in its sum: +1 increasing, -1
+//decreasing, 0 constant, 2 unknown
+inline int monoAdd(int a, int b) {
+    if(a == 0) return b;
+    if(b == 0) return a;
+    return (a == b && a != 2) ? a : 2;
+}
+
+inline int monoScale(int m, double c) {
+    if(m == 0 || m == 2) return m;
+    if(c > 0.0) return m;
+    if(c < 0.0) return -m;
+    return 0;
+}
+
+//---- Nodes ----
+struct Node {};
+
+template<class T>
+struct is_node : std::is_base_of<Node, typename std::decay<T>::type> {};
+
+struct Const : Node {
+    enum { sums = 0, uses_next = 0 };
+    double v;
+    explicit Const(double v_) : v(v_) {}
+    double at(const double*, int, int) const { return v; }
+    Interval range() const { return Interval{v, v}; }
+    double value(const double*, int) const { return v; }
+    double withSum(double, int) const { return v; }
+    int monotone(int) const { return 0; }
+};
+
+struct X : Node {
+    enum { sums = 0, uses_next = 0 };
+    double at(const double* z, int i, int) const { return z[i]; }
+    Interval range() const { return whole(); }
+};
+
+struct XNext : Node {
+    enum { sums = 0, uses_next = 1 };
+    double at(const double* z, int i, int) const { return z[i + 1]; }
+    Interval range() const { return whole(); }
+};
+
+struct Index : Node {
+    enum { sums = 0, uses_next = 0 };
+    double at(const double*, int i, int) const { return static_cast<double>(i); }
+    Interval range() const { return Interval{0.0, std::numeric_limits<double>::infinity()}; }
+};
+
+struct Dim : Node {
+    enum { sums = 0, uses_next = 0 };
+    double at(const double*, int, int D) const { return static_cast<double>(D); }
+    Interval range() const { return Interval{1.0, std::numeric_limits<double>::infinity()}; }
+    double value(const double*, int D) const { return static_cast<double>(D); }
+    double withSum(double, int D) const { return static_cast<double>(D); }
+    int monotone(int) const { return 0; }
+};
+
+const X x = X();
+const XNext x_next = XNext();
+const Index i = Index();
+const Dim D = Dim();
+
+template<class T, bool IsNode = is_node<T>::value>
+struct wrap { typedef Const type; static Const make(double v) { return Const(v); } };
+
+template<class T>
+struct wrap<T, true> {
+    typedef typename std::decay<T>::type type;
+    static const type& make(const type& t) { return t; }
+};
+
+//---- Operators ----
+struct AddOp {
+    static double apply(double a, double b) { return a + b; }
+    static Interval range(Interval a, Interval b) { return Interval{a.lo + b.lo, a.hi + b.hi}; }
+    static int mono(int a, int b, double, double) { return monoAdd(a, b); }
+};
+
+struct SubOp {
+    static double apply(double a, double b) { return a - b; }
+    static Interval range(Interval a, Interval b) { return Interval{a.lo - b.hi, a.hi - b.lo}; }
+    static int mono(int a, int b, double, double) { return monoAdd(a, b == 2 ? 2 : -b); }
+};
+
+struct MulOp {
+    static double apply(double a, double b) { return a * b; }
+    static Interval range(Interval a, Interval b) { return imul(a, b); }
+    static int mono(int a, int b, double va, double vb) {
+        if(a == 0) return monoScale(b, va);
+        if(b == 0) return monoScale(a, vb);
+        return 2;
+    }
+};
+
+struct DivOp {
+    static double apply(double a, double b) { return a / b; }
+    static Interval range(Interval a, Interval b) {
+        if(b.lo <= 0.0 && b.hi >= 0.0) return whole();
+        return imul(a, Interval{1.0 / b.hi, 1.0 / b.lo});
+    }
+    static int mono(int a, int b, double, double vb) { return b == 0 ? monoScale(a, vb) : 2; }
+};
+
+struct PowOp {
+    static double apply(double a, double b) { return std::pow(a, b); }
+    static Interval range(Interval a, Interval) {
+        if(a.lo >= 0.0) return Interval{0.0, std::numeric_limits<double>::infinity()};
+        return whole();
+    }
+    static int mono(int a, int b, double, double) { return (a == 0 && b == 0) ? 0 : 2; }
+};
+
+template<class Op, class L, class R>
+struct Binary : Node {
+    enum { sums = L::sums + R::sums, uses_next = L::uses_next || R::uses_next };
+    L l;
+    R r;
+    Binary(const L& l_, const R& r_) : l(l_), r(r_) {}
+
+    double at(const double* z, int i, int D) const { return Op::apply(l.at(z, i, D), r.at(z, i, D)); }
+    Interval range() const { return Op::range(l.range(), r.range()); }
+
+    double value(const double* z, int D) const { return Op::apply(l.value(z, D), r.value(z, D)); }
+    double withSum(double S, int D) const { return Op::apply(l.withSum(S, D), r.withSum(S, D)); }
+    int monotone(int D) const {
+        //withSum(0, D) of a constant side is its value at dimension D
+        return Op::mono(l.monotone(D), r.monotone(D), l.withSum(0.0, D), r.withSum(0.0, D));
+    }
+};
+
+//x*x and x_next*x_next are squares
+template<>
+inline Interval Binary<MulOp, X, X>::range() const {
+    return Interval{0.0, std::numeric_limits<double>::infinity()};
+}
+
+template<>
+inline Interval Binary<MulOp, XNext, XNext>::range() const {
+    return Interval{0.0, std::numeric_limits<double>::infinity()};
+}
+
+struct NegOp {
+    static double apply(double a) { return -a; }
+    static Interval range(Interval a) { return Interval{-a.hi, -a.lo}; }
+    static int mono(int m) { return m == 2 ? 2 : -m; }
+};
+struct SqOp {
+    static double apply(double a) { return a * a; }
+    static Interval range(Interval a) { return isq(a); }
+    static int mono(int m) { return m == 0 ? 0 : 2; }
+};
+struct AbsOp {
+    static double apply(double a) { return std::fabs(a); }
+    static Interval range(Interval a) {
+        if(a.lo >= 0.0) return a;
+        if(a.hi <= 0.0) return Interval{-a.hi, -a.lo};
+        return Interval{0.0, std::max(-a.lo, a.hi)};
+    }
+    static int mono(int m) { return m == 0 ? 0 : 2; }
+};
+struct CosOp {
+    static double apply(double a) { return std::cos(a); }
+    static Interval range(Interval) { return Interval{-1.0, 1.0}; }
+    static int mono(int m) { return m == 0 ? 0 : 2; }
+};
+struct SinOp {
+    static double apply(double a) { return std::sin(a); }
+    static Interval range(Interval) { return Interval{-1.0, 1.0}; }
+    static int mono(int m) { return m == 0 ? 0 : 2; }
+};
+struct ExpOp {
+    static double apply(double a) { return std::exp(a); }
+    static Interval range(Interval a) { return Interval{std::exp(a.lo), std::exp(a.hi)}; }
+    static int mono(int m) { return m; }
+};
+struct SqrtOp {
+    static double apply(double a) { return std::sqrt(a); }
+    static Interval range(Interval a) { return Interval{std::sqrt(std::max(a.lo, 0.0)), std::sqrt(std::max(a.hi, 0.0))}; }
+    static int mono(int m) { return m; }
+};
+
+template<class Op, class E>
+struct Unary : Node {
+    enum { sums = E::sums, uses_next = E::uses_next };
+    E e;
+    explicit Unary(const E& e_) : e(e_) {}
+
+    double at(const double* z, int i, int D) const { return Op::apply(e.at(z, i, D)); }
+    Interval range() const { return Op::range(e.range()); }
+
+    double value(const double* z, int D) const { return Op::apply(e.value(z, D)); }
+    double withSum(double S, int D) const { return Op::apply(e.withSum(S, D)); }
+    int monotone(int D) const { return Op::mono(e.monotone(D)); }
+};
+
+//sum over i of a term: one fused loop over the coordinates
+template<class E>
+struct Sum : Node {
+    enum { sums = 1, uses_next = 0 };
+    E term;
+    explicit Sum(const E& term_) : term(term_) {}
+
+    int count(int D) const { return E::uses_next ? D - 1 : D; }
+
+    double value(const double* z, int D) const {
+        double s = 0.0;
+        int n = count(D);
+        for(int k = 0; k < n; ++k) {
+            s += term.at(z, k, D);
+        }
+        return s;
+    }
+    double withSum(double S, int) const { return S; }
+    int monotone(int) const { return 1; }
+};
+
+#define DSL_BINARY_OPERATOR(op, Op)                                                         \
+    template<class A, class B>                                                              \
+    typename std::enable_if<is_node<A>::value || is_node<B>::value,                         \
+                            Binary<Op, typename wrap<A>::type, typename wrap<B>::type>>::type \
+    operator op(const A& a, const B& b) {                                                   \
+        return Binary<Op, typename wrap<A>::type, typename wrap<B>::type>(wrap<A>::make(a), wrap<B>::make(b)); \
+    }
+
+DSL_BINARY_OPERATOR(+, AddOp)
+DSL_BINARY_OPERATOR(-, SubOp)
+DSL_BINARY_OPERATOR(*, MulOp)
+DSL_BINARY_OPERATOR(/, DivOp)
+#undef DSL_BINARY_OPERATOR
+
+template<class A, class B>
+typename std::enable_if<is_node<A>::value || is_node<B>::value,
+                        Binary<PowOp, typename wrap<A>::type, typename wrap<B>::type>>::type
+pow(const A& a, const B& b) {
+    return Binary<PowOp, typename wrap<A>::type, typename wrap<B>::type>(wrap<A>::make(a), wrap<B>::make(b));
+}
+
+#define DSL_UNARY_FUNCTION(name, Op)                                                        \
+    template<class E>                                                                       \
+    typename std::enable_if<is_node<E>::value, Unary<Op, E>>::type name(const E& e) {       \
+        return Unary<Op, E>(e);                                                             \
+    }
+
+DSL_UNARY_FUNCTION(operator-, NegOp)
+DSL_UNARY_FUNCTION(sq, SqOp)
+DSL_UNARY_FUNCTION(abs, AbsOp)
+DSL_UNARY_FUNCTION(cos, CosOp)
+DSL_UNARY_FUNCTION(sin, SinOp)
+DSL_UNARY_FUNCTION(exp, ExpOp)
+DSL_UNARY_FUNCTION(sqrt, SqrtOp)
+#undef DSL_UNARY_FUNCTION
+
+template<class E>
+typename std::enable_if<is_node<E>::value, Sum<E>>::type sum(const E& term) {
+    static_assert(E::sums == 0, "sum() terms cannot contain another sum()");
+    return Sum<E>(term);
+}
+
+//Finds the single Sum node of a scalar expression, for bounded evaluation
+template<class T>
+struct SumOf { typedef void type; static const void* get(const T&) { return nullptr; } };
+
+template<class E>
+struct SumOf<Sum<E>> { typedef Sum<E> type; static const Sum<E>* get(const Sum<E>& s) { return &s; } };
+
+template<class Op, class L, class R>
+struct SumOf<Binary<Op, L, R>> {
+    typedef typename std::conditional<L::sums == 1, typename SumOf<L>::type, typename SumOf<R>::type>::type type;
+    static const type* get(const Binary<Op, L, R>& b) { return pick(b, std::integral_constant<bool, L::sums == 1>()); }
+    static const type* pick(const Binary<Op, L, R>& b, std::true_type) { return SumOf<L>::get(b.l); }
+    static const type* pick(const Binary<Op, L, R>& b, std::false_type) { return SumOf<R>::get(b.r); }
+};
+
+template<class Op, class E>
+struct SumOf<Unary<Op, E>> {
+    typedef typename SumOf<E>::type type;
+    static const type* get(const Unary<Op, E>& u) { return SumOf<E>::get(u.e); }
+};
+
+//---- Compiled objective with CEC-style shift / scale / rotation ----
+template<class Expr>
+class Objective {
+    static_assert(Expr::sums >= 1, "an objective needs at least one sum()");
+
+    Expr expr;
+    std::vector<double> shift;      //o, empty: no shift
+    std::vector<double> rotation;   //M, row-major D x D, empty: no rotation
+    double scale = 1.0;
+    mutable std::vector<double> y, z;
+
+    double termLowerBound;          //-inf: no early abort
+    mutable int increasing_dim = 0; //Dimension increasing was decided for, 0: none yet
+    mutable bool increasing = false;
+
+    //z = M * (scale * (x - o)), as CEC sr_func
+    const double* transform(const std::vector<double>& x) const {
+        int n = static_cast<int>(x.size());
+        if(shift.empty() && rotation.empty() && scale == 1.0) return x.data();
+
+        y.resize(n);
+        for(int d = 0; d < n; ++d) {
+            y[d] = (shift.empty() ? x[d] : x[d] - shift[d]) * scale;
+        }
+        if(rotation.empty()) return y.data();
+
+        z.resize(n);
+        for(int r = 0; r < n; ++r) {
+            const double* row = &rotation[static_cast<size_t>(r) * n];
+            double acc = 0.0;
+            for(int c = 0; c < n; ++c) acc += row[c] * y[c];
+            z[r] = acc;
+        }
+        return z.data();
+    }
+
+    template<class S>
+    double boundedSum(const S& s, const double* zp, int n, double bound) const {
+        int count = s.count(n);
+        double acc = 0.0;
+        int k = 0;
+        //Check the bound once per block of 8 terms so the inner loop stays branch-free
+        for(; k + 8 <= count; k += 8) {
+            for(int j = k; j < k + 8; ++j) {
+                acc += s.term.at(zp, j, n);
+            }
+            double lower = expr.withSum(acc + (count - k - 8) * termLowerBound, n);
+            if(lower >= bound) return lower;
+        }
+        for(; k < count; ++k) {
+            acc += s.term.at(zp, k, n);
+        }
+        return expr.withSum(acc, n);
+    }
+
+    double boundedImpl(const double* zp, int n, double bound, std::true_type) const {
+        return boundedSum(*SumOf<Expr>::get(expr), zp, n, bound);
+    }
+    double boundedImpl(const double* zp, int n, double, std::false_type) const {
+        return expr.value(zp, n);
+    }
+
+public:
+    explicit Objective(const Expr& e) : expr(e) {
+        termLowerBound = -std::numeric_limits<double>::infinity();
+        initBound(std::integral_constant<bool, Expr::sums == 1>());
+    }
+
+    Objective& shifted(const std::vector<double>& o) { shift = o; return *this; }
+    Objective& scaled(double s) { scale = s; return *this; }
+    Objective& rotated(const std::vector<double>& M) { rotation = M; return *this; }
+
+    double operator()(const std::vector<double>& x) const {
+        return expr.value(transform(x), static_cast<int>(x.size()));
+    }
+
+    //Bounded objective protocol (see CHxPSO_ABS::setBoundedObjective)
+    double bounded(const std::vector<double>& x, double bound) const {
+        const double* zp = transform(x);
+        int n = static_cast<int>(x.size());
+        if(!supportsEarlyAbort(n)) return expr.value(zp, n);
+        return boundedImpl(zp, n, bound, std::integral_constant<bool, Expr::sums == 1>());
+    }
+
+    //Whether bounded() can stop early at dimension D
+    bool supportsEarlyAbort(int D) const {
+        if(termLowerBound == -std::numeric_limits<double>::infinity()) return false;
+        if(D != increasing_dim) {
+            increasing = expr.monotone(D) == 1;
+            increasing_dim = D;
+        }
+        return increasing;
+    }
+
+private:
+    void initBound(std::true_type) {
+        termLowerBound = SumOf<Expr>::get(expr)->term.range().lo;
+    }
+    void initBound(std::false_type) {}
+};
+
+template<class Expr>
+Objective<Expr> compile(const Expr& e) {
+    return Objective<Expr>(e);
+}
+
+} // namespace dsl
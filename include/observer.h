@@ -0,0 +1,155 @@
+#pragma once
+#include "particle.h"
+#include <ostream>
+#include <cmath>
+#include <string>
+#include <vector>
+
+//Run-loop events of a swarm. Attach with setObserver(); with no observer the
+//swarm only tests a null pointer per event. An observer belongs to one
+//thread: swarms run concurrently need one observer each.
+class SwarmObserver {
+public:
+    virtual ~SwarmObserver() {}
+
+    virtual void onImprovement(int FEs, double best_fit) {}            //gbest improved
+    virtual void onReconstruction(int FEs, int layer) {}               //Q rebuilt by the ABS
+    virtual void onSelection(int FEs, int layer, Role role) {}         //Er or Ei chosen to move
+    virtual void onThresholds(int FEs, int M_Er, int M_Ei) {}          //ABS thresholds changed
+    virtual void onSweepEnd(int FEs, double best_fit) {}               //Pass over all layers done
+    virtual void onRunEnd(int FEs, double best_fit) {}
+};
+
+//Explicitly silent observer (same as attaching none)
+class QuietObserver : public SwarmObserver {};
+
+//"FEs: ... Best Fit: ..." once per interval FEs, checked at sweep ends, and at run end
+class ProgressObserver : public SwarmObserver {
+    std::ostream& out;
+    int interval;
+    int next_report;
+    std::string label;
+
+    void report(int FEs, double best_fit) {
+        if(!label.empty()) out << label << " ";
+        out << "FEs: " << FEs << " Best Fit: " << best_fit << '\n';
+    }
+
+public:
+    ProgressObserver(std::ostream& out_, int interval_FEs, const std::string& label_ = "")
+        : out(out_), interval(interval_FEs > 0 ? interval_FEs : 1), next_report(interval), label(label_) {}
+
+    void onSweepEnd(int FEs, double best_fit) override {
+        if(FEs < next_report) return;
+        report(FEs, best_fit);
+        next_report = (FEs / interval + 1) * interval;
+    }
+
+    void onRunEnd(int FEs, double best_fit) override {
+        report(FEs, best_fit);
+        out.flush();
+    }
+};
+
+//One JSON object per line for the events selected in mask, e.g.
+//{"run":"F3/10D/1","event":"improvement","fes":2040,"best":12.5}
+class JsonLinesObserver : public SwarmObserver {
+    std::ostream& out;
+    unsigned mask;
+    std::string run;
+
+    void begin(const char* event, int FEs) {
+        out << "{\"run\":\"" << run << "\",\"event\":\"" << event << "\",\"fes\":" << FEs;
+    }
+
+    //Full precision; JSON has no inf/nan
+    void number(double v) {
+        if(std::isfinite(v)) {
+            out << v;
+        } else {
+            out << "null";
+        }
+    }
+
+public:
+    enum Events {
+        IMPROVEMENT = 1, RECONSTRUCTION = 2, SELECTION = 4, THRESHOLDS = 8, SWEEP_END = 16, RUN_END = 32,
+        ALL = 63
+    };
+
+    //Selection events fire once per evaluation, so they are off by default
+    JsonLinesObserver(std::ostream& out_, const std::string& run_label, unsigned event_mask = ALL & ~SELECTION)
+        : out(out_), mask(event_mask), run(run_label) {
+        out.precision(17);
+    }
+
+    void onImprovement(int FEs, double best_fit) override {
+        if(!(mask & IMPROVEMENT)) return;
+        begin("improvement", FEs);
+        out << ",\"best\":";
+        number(best_fit);
+        out << "}\n";
+    }
+
+    void onReconstruction(int FEs, int layer) override {
+        if(!(mask & RECONSTRUCTION)) return;
+        begin("reconstruction", FEs);
+        out << ",\"layer\":" << layer << "}\n";
+    }
+
+    void onSelection(int FEs, int layer, Role role) override {
+        if(!(mask & SELECTION)) return;
+        begin("selection", FEs);
+        out << ",\"layer\":" << layer << ",\"role\":\"" << (role == ER ? "Er" : "Ei") << "\"}\n";
+    }
+
+    void onThresholds(int FEs, int M_Er, int M_Ei) override {
+        if(!(mask & THRESHOLDS)) return;
+        begin("thresholds", FEs);
+        out << ",\"M_Er\":" << M_Er << ",\"M_Ei\":" << M_Ei << "}\n";
+    }
+
+    void onSweepEnd(int FEs, double best_fit) override {
+        if(!(mask & SWEEP_END)) return;
+        begin("sweep_end", FEs);
+        out << ",\"best\":";
+        number(best_fit);
+        out << "}\n";
+    }
+
+    void onRunEnd(int FEs, double best_fit) override {
+        if(!(mask & RUN_END)) return;
+        begin("run_end", FEs);
+        out << ",\"best\":";
+        number(best_fit);
+        out << "}\n";
+    }
+};
+
+//Forwards every event to several observers (not owned)
+class ObserverFanout : public SwarmObserver {
+    std::vector<SwarmObserver*> targets;
+
+public:
+    void add(SwarmObserver* obs) { targets.push_back(obs); }
+    bool empty() const { return targets.empty(); }
+
+    void onImprovement(int FEs, double best_fit) override {
+        for(SwarmObserver* t : targets) t->onImprovement(FEs, best_fit);
+    }
+    void onReconstruction(int FEs, int layer) override {
+        for(SwarmObserver* t : targets) t->onReconstruction(FEs, layer);
+    }
+    void onSelection(int FEs, int layer, Role role) override {
+        for(SwarmObserver* t : targets) t->onSelection(FEs, layer, role);
+    }
+    void onThresholds(int FEs, int M_Er, int M_Ei) override {
+        for(SwarmObserver* t : targets) t->onThresholds(FEs, M_Er, M_Ei);
+    }
+    void onSweepEnd(int FEs, double best_fit) override {
+        for(SwarmObserver* t : targets) t->onSweepEnd(FEs, best_fit);
+    }
+    void onRunEnd(int FEs, double best_fit) override {
+        for(SwarmObserver* t : targets) t->onRunEnd(FEs, best_fit);
+    }
+};
@@ -3,22 +3,27 @@
 
 enum Role { ER, EI }; //Exploration or Exploitation
 
-struct Particle {
-    std::vector<double> x;      //Position
-    std::vector<double> v;      //Velocity
-    std::vector<double> pbest;  //Personal best (not used in CHxPSO, kept for compatibility)
-    double pbest_fit;
+//Real is the precision of the swarm state (double, or float to halve its
+//memory traffic); fitness values stay double
+template<class Real>
+struct BasicParticle {
+    std::vector<Real> x;        //Position
+    std::vector<Real> v;        //Velocity
     Role role;
     
     //Employment counter (α_Er or α_Ei)
     int alpha;
 };
 
-struct Layer {
-    Particle Er;                    //Exploration particle
-    Particle Ei;                    //Exploitation particle
-    std::vector<double> L;          //Single-layer best vector
+template<class Real>
+struct BasicLayer {
+    BasicParticle<Real> Er;         //Exploration particle
+    BasicParticle<Real> Ei;         //Exploitation particle
+    std::vector<Real> L;            //Single-layer best vector
     double L_fit;                   //Fitness of L
-    std::vector<double> Q;          //Constructed exemplar vector
+    std::vector<Real> Q;            //Constructed exemplar vector
     int beta;                       //Counter for L updates by Er particle (at layer level)
-};
\ No newline at end of file
+};
+
+typedef BasicParticle<double> Particle;
+typedef BasicLayer<double> Layer;
@@ -0,0 +1,325 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <ostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
+//Stored performance baselines (JSON) and noise-aware comparison against them.
+//An entry is the summary of repeated samples of one metric of one
+//(group, case, dim): ns per call or per FE over timing trials, or final
+//error over seeded runs. Lower is better for every metric.
+//
+//  {"format": "chxpso-baseline-1", "variant": "chclpso", "entries": [
+//    {"group": "cec17", "name": "F5", "dim": 10, "metric": "ns_per_call",
+//     "n": 7, "mean": 346.1, "stddev": 4.2, "median": 345.9},
+//    ...]}
+
+struct BaselineEntry {
+    std::string group, name;
+    int dim;
+    std::string metric;             //"ns_per_call", "ns_per_fe" or "error"
+    int n;                          //Samples
+    double mean, stddev, median;    //Sample standard deviation
+};
+
+inline bool isSpeedMetric(const std::string& metric) { return metric != "error"; }
+
+//Summary of samples as an entry
+inline BaselineEntry summarize(const std::string& group, const std::string& name, int dim,
+                               const std::string& metric, std::vector<double> samples) {
+    BaselineEntry e = {group, name, dim, metric, static_cast<int>(samples.size()), 0.0, 0.0, 0.0};
+    if(samples.empty()) return e;
+    for(double s : samples) e.mean += s;
+    e.mean /= samples.size();
+    for(double s : samples) e.stddev += (s - e.mean) * (s - e.mean);
+    e.stddev = samples.size() > 1 ? std::sqrt(e.stddev / (samples.size() - 1)) : 0.0;
+    std::sort(samples.begin(), samples.end());
+    size_t h = samples.size() / 2;
+    e.median = samples.size() % 2 ? samples[h] : 0.5 * (samples[h - 1] + samples[h]);
+    return e;
+}
+
+//Minimal reader for the baseline file: objects, arrays, strings, numbers,
+//true/false/null. Unknown keys are skipped.
+class BaselineReader {
+    const std::string& text;
+    size_t pos = 0;
+
+    void skipSpace() {
+        while(pos < text.size() && (text[pos] == ' ' || text[pos] == '\n' || text[pos] == '\r' || text[pos] == '\t')) pos++;
+    }
+
+public:
+    explicit BaselineReader(const std::string& text_) : text(text_) {}
+
+    bool consume(char c) {
+        skipSpace();
+        if(pos < text.size() && text[pos] == c) {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    bool peek(char c) {
+        skipSpace();
+        return pos < text.size() && text[pos] == c;
+    }
+
+    bool string(std::string& out) {
+        if(!consume('"')) return false;
+        out.clear();
+        while(pos < text.size() && text[pos] != '"') {
+            if(text[pos] == '\\' && pos + 1 < text.size()) pos++;
+            out += text[pos++];
+        }
+        return consume('"');
+    }
+
+    //A number, or null as NaN
+    bool number(double& out) {
+        skipSpace();
+        if(text.compare(pos, 4, "null") == 0) {
+            pos += 4;
+            out = std::numeric_limits<double>::quiet_NaN();
+            return true;
+        }
+        const char* start = text.c_str() + pos;
+        char* end;
+        out = std::strtod(start, &end);
+        if(end == start) return false;
+        pos += end - start;
+        return true;
+    }
+
+    //Skip any value
+    bool skip() {
+        std::string s;
+        double d;
+        if(peek('"')) return string(s);
+        if(consume('{')) {
+            if(consume('}')) return true;
+            do {
+                if(!string(s) || !consume(':') || !skip()) return false;
+            } while(consume(','));
+            return consume('}');
+        }
+        if(consume('[')) {
+            if(consume(']')) return true;
+            do {
+                if(!skip()) return false;
+            } while(consume(','));
+            return consume(']');
+        }
+        skipSpace();
+        if(text.compare(pos, 4, "true") == 0) { pos += 4; return true; }
+        if(text.compare(pos, 5, "false") == 0) { pos += 5; return true; }
+        return number(d);
+    }
+};
+
+class PerfBaseline {
+    std::vector<BaselineEntry> entries;
+
+    static void writeNumber(std::ostream& out, double v) {
+        if(!std::isfinite(v)) {
+            out << "null";
+            return;
+        }
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.17g", v);
+        out << buffer;
+    }
+
+    static bool readEntry(BaselineReader& in, BaselineEntry& e) {
+        e = BaselineEntry{"", "", 0, "", 0, 0.0, 0.0, 0.0};
+        if(!in.consume('{')) return false;
+        if(in.consume('}')) return true;
+        std::string key;
+        double value;
+        do {
+            if(!in.string(key) || !in.consume(':')) return false;
+            bool ok;
+            if(key == "group") ok = in.string(e.group);
+            else if(key == "name") ok = in.string(e.name);
+            else if(key == "metric") ok = in.string(e.metric);
+            else if(key == "dim" || key == "n" || key == "mean" || key == "stddev" || key == "median") {
+                ok = in.number(value);
+                if(key == "dim") e.dim = static_cast<int>(value);
+                else if(key == "n") e.n = static_cast<int>(value);
+                else if(key == "mean") e.mean = value;
+                else if(key == "stddev") e.stddev = value;
+                else e.median = value;
+            } else {
+                ok = in.skip();
+            }
+            if(!ok) return false;
+        } while(in.consume(','));
+        return in.consume('}');
+    }
+
+public:
+    std::string variant;
+
+    void add(const BaselineEntry& e) { entries.push_back(e); }
+
+    const std::vector<BaselineEntry>& getEntries() const { return entries; }
+
+    const BaselineEntry* find(const std::string& group, const std::string& name, int dim,
+                              const std::string& metric) const {
+        for(const BaselineEntry& e : entries) {
+            if(e.dim == dim && e.group == group && e.name == name && e.metric == metric) return &e;
+        }
+        return nullptr;
+    }
+
+    bool write(const std::string& path) const {
+        std::ofstream out(path);
+        if(!out) return false;
+        out << "{\"format\": \"chxpso-baseline-1\", \"variant\": \"" << variant << "\", \"entries\": [";
+        for(size_t k = 0; k < entries.size(); ++k) {
+            const BaselineEntry& e = entries[k];
+            out << (k ? ",\n" : "\n") << "  {\"group\": \"" << e.group << "\", \"name\": \"" << e.name
+                << "\", \"dim\": " << e.dim << ", \"metric\": \"" << e.metric << "\", \"n\": " << e.n << ", \"mean\": ";
+            writeNumber(out, e.mean);
+            out << ", \"stddev\": ";
+            writeNumber(out, e.stddev);
+            out << ", \"median\": ";
+            writeNumber(out, e.median);
+            out << "}";
+        }
+        out << "\n]}\n";
+        return static_cast<bool>(out);
+    }
+
+    //False if the file is missing or not a baseline
+    bool load(const std::string& path) {
+        std::ifstream file(path);
+        if(!file) return false;
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        std::string text = buffer.str();
+
+        entries.clear();
+        BaselineReader in(text);
+        std::string key;
+        if(!in.consume('{')) return false;
+        do {
+            if(!in.string(key) || !in.consume(':')) return false;
+            if(key == "variant") {
+                if(!in.string(variant)) return false;
+            } else if(key == "entries") {
+                if(!in.consume('[')) return false;
+                if(!in.consume(']')) {
+                    do {
+                        BaselineEntry e;
+                        if(!readEntry(in, e)) return false;
+                        entries.push_back(e);
+                    } while(in.consume(','));
+                    if(!in.consume(']')) return false;
+                }
+            } else if(!in.skip()) {
+                return false;
+            }
+        } while(in.consume(','));
+        return in.consume('}');
+    }
+};
+
+//Two-sided 95% Student t quantile
+inline double tCritical95(double df) {
+    static const double table[30] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    if(!(df >= 1.0)) return table[0];
+    if(df <= 30.0) return table[static_cast<int>(df) - 1];
+    return 1.96 + 2.4 / df;
+}
+
+//Thresholds of compareBaselines. A change counts only when the whole 95%
+//confidence interval of the difference of means (Welch) lies beyond the
+//tolerance: a fraction of the baseline mean, and for errors at least the
+//absolute floor (CEC errors below 1e-8 count as zero). Trials of one process
+//share its frequency and cache state, so timings need a quiet, pinned machine
+//and a tolerance above the run-to-run drift seen there.
+struct RegressionThresholds {
+    double speed_tolerance = 0.05;
+    double error_tolerance = 0.05;
+    double error_floor = 1e-8;
+};
+
+enum RegressionFlags {
+    NO_REGRESSION = 0,
+    SPEED_REGRESSION = 2,
+    QUALITY_REGRESSION = 4
+};
+
+//Compare current against baseline entry by entry and print the speed and the
+//quality sections separately. Returns the RegressionFlags found.
+inline int compareBaselines(const PerfBaseline& baseline, const PerfBaseline& current,
+                            const RegressionThresholds& thresholds, std::ostream& out) {
+    int flags = NO_REGRESSION;
+    for(int pass = 0; pass < 2; ++pass) {
+        bool speed = pass == 0;
+        int regressions = 0, improvements = 0, compared = 0, missing = 0;
+        out << "\n=== " << (speed ? "Speed" : "Solution quality (final error)") << " vs baseline ===" << '\n';
+        out << std::left << std::setw(10) << "group" << std::setw(22) << "case" << std::right << std::setw(6) << "dim"
+            << std::setw(14) << "metric" << std::setw(16) << "baseline" << std::setw(16) << "current"
+            << std::setw(10) << "change" << "  95% CI of change      verdict" << '\n';
+
+        for(const BaselineEntry& c : current.getEntries()) {
+            if(isSpeedMetric(c.metric) != speed) continue;
+            const BaselineEntry* b = baseline.find(c.group, c.name, c.dim, c.metric);
+            if(!b) {
+                missing++;
+                continue;
+            }
+            compared++;
+
+            //Welch confidence interval of current - baseline
+            double diff = c.mean - b->mean;
+            double vb = b->n > 0 ? b->stddev * b->stddev / b->n : 0.0;
+            double vc = c.n > 0 ? c.stddev * c.stddev / c.n : 0.0;
+            double se = std::sqrt(vb + vc);
+            double half = 0.0;
+            if(se > 0.0) {
+                double df = (vb + vc) * (vb + vc) /
+                    ((b->n > 1 ? vb * vb / (b->n - 1) : 0.0) + (c.n > 1 ? vc * vc / (c.n - 1) : 0.0));
+                half = tCritical95(df) * se;
+            }
+            double tolerance = (speed ? thresholds.speed_tolerance : thresholds.error_tolerance) * std::fabs(b->mean);
+            if(!speed) tolerance = std::max(tolerance, thresholds.error_floor);
+
+            const char* verdict = "same";
+            if(diff - half > tolerance) {
+                verdict = "REGRESSION";
+                regressions++;
+            } else if(diff + half < -tolerance) {
+                verdict = "improved";
+                improvements++;
+            }
+
+            double scale = b->mean != 0.0 ? 100.0 / std::fabs(b->mean) : 0.0;
+            out << std::left << std::setw(10) << c.group << std::setw(22) << c.name << std::right << std::setw(6) << c.dim
+                << std::setw(14) << c.metric << std::scientific << std::setprecision(4)
+                << std::setw(16) << b->mean << std::setw(16) << c.mean << std::fixed << std::setprecision(1)
+                << std::setw(9) << diff * scale << "%  [" << std::setw(7) << (diff - half) * scale << "%, "
+                << std::setw(7) << (diff + half) * scale << "%]   " << verdict << '\n';
+        }
+        out << std::defaultfloat;
+        out << compared << " compared, " << regressions << " regressions, " << improvements << " improvements";
+        if(missing) out << ", " << missing << " not in the baseline";
+        out << '\n';
+        if(regressions) flags |= speed ? SPEED_REGRESSION : QUALITY_REGRESSION;
+    }
+    return flags;
+}
@@ -0,0 +1,262 @@
+#pragma once
+#include <chrono>
+#include <ostream>
+#include <iomanip>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <memory>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+//Phases of the run loop timed by a PhaseProfiler. Everything outside the
+//other phases (R&P boxes, ask/tell and runner overhead) is bookkeeping.
+enum ProfilePhase {
+    PHASE_THRESHOLDS,       //ABS threshold calculation
+    PHASE_SELECT,           //selectParticle
+    PHASE_CONSTRUCT_Q,
+    PHASE_UPDATE_ER,
+    PHASE_UPDATE_EI,
+    PHASE_EVALUATE,         //Objective (see addEvaluationStages for the CEC breakdown)
+    PHASE_BOOKKEEPING,
+    NUM_PHASES
+};
+
+inline const char* phaseName(ProfilePhase phase) {
+    static const char* names[NUM_PHASES] = {
+        "thresholds", "selectParticle", "constructQ", "Er update", "Ei update", "evaluate", "bookkeeping"
+    };
+    return names[phase];
+}
+
+//Cycles, instructions and LLC misses of the calling thread (user space only)
+//as one perf_event_open group. available() is false when the kernel refuses
+//the events (no PMU, perf_event_paranoid, containers); nothing is counted then.
+class HardwareCounters {
+public:
+    enum { CYCLES, INSTRUCTIONS, LLC_MISSES, NUM_COUNTERS };
+
+private:
+    int fds[NUM_COUNTERS];
+
+    static int open(uint64_t config, int group_fd) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = group_fd < 0 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+    }
+
+public:
+    HardwareCounters() {
+        fds[CYCLES] = open(PERF_COUNT_HW_CPU_CYCLES, -1);
+        fds[INSTRUCTIONS] = fds[CYCLES] >= 0 ? open(PERF_COUNT_HW_INSTRUCTIONS, fds[CYCLES]) : -1;
+        fds[LLC_MISSES] = fds[CYCLES] >= 0 ? open(PERF_COUNT_HW_CACHE_MISSES, fds[CYCLES]) : -1;
+        if(!available()) {
+            close();
+            return;
+        }
+        ioctl(fds[CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds[CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    ~HardwareCounters() { close(); }
+
+    HardwareCounters(const HardwareCounters&) = delete;
+    HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+    bool available() const {
+        return fds[CYCLES] >= 0 && fds[INSTRUCTIONS] >= 0 && fds[LLC_MISSES] >= 0;
+    }
+
+    //Running totals since construction; false if unavailable or the read failed
+    bool read(uint64_t values[NUM_COUNTERS]) const {
+        if(!available()) return false;
+        uint64_t buffer[1 + NUM_COUNTERS];
+        if(::read(fds[CYCLES], buffer, sizeof(buffer)) != static_cast<ssize_t>(sizeof(buffer))) return false;
+        for(int k = 0; k < NUM_COUNTERS; ++k) values[k] = buffer[1 + k];
+        return true;
+    }
+
+    void close() {
+        for(int k = NUM_COUNTERS - 1; k >= 0; --k) {
+            if(fds[k] >= 0) ::close(fds[k]);
+            fds[k] = -1;
+        }
+    }
+};
+
+//Splits the time (and optionally hardware counts) of the runs it is attached
+//to into ProfilePhases. Time is charged to the current phase until the next
+//switch, so the phases add up to the wall time between start() and stop().
+//Each switch reads the clock, and the counters when enabled (a system call),
+//so profiled runs are slower than plain ones; compare shares, not totals.
+//One profiler belongs to one thread.
+class PhaseProfiler {
+public:
+    struct Totals {
+        double ns = 0.0;
+        long long calls = 0;                            //Entries into the phase
+        uint64_t counters[HardwareCounters::NUM_COUNTERS] = {0, 0, 0};
+    };
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    Totals totals[NUM_PHASES];
+    ProfilePhase current = PHASE_BOOKKEEPING;
+    bool running = false;
+    Clock::time_point mark;
+    uint64_t counter_mark[HardwareCounters::NUM_COUNTERS];
+    std::unique_ptr<HardwareCounters> hardware;
+
+    //Stages inside PHASE_EVALUATE reported by the objective
+    double shift_rotate_ns = 0.0;
+    double cf_cal_ns = 0.0;
+
+    void charge() {
+        Clock::time_point now = Clock::now();
+        totals[current].ns += std::chrono::duration<double, std::nano>(now - mark).count();
+        mark = now;
+
+        uint64_t values[HardwareCounters::NUM_COUNTERS];
+        if(hardware && hardware->read(values)) {
+            for(int k = 0; k < HardwareCounters::NUM_COUNTERS; ++k) {
+                totals[current].counters[k] += values[k] - counter_mark[k];
+                counter_mark[k] = values[k];
+            }
+        }
+    }
+
+public:
+    explicit PhaseProfiler(bool hardware_counters = false) {
+        if(hardware_counters) {
+            hardware.reset(new HardwareCounters());
+            if(!hardware->available()) hardware.reset();
+        }
+    }
+
+    bool hasHardwareCounters() const { return hardware != nullptr; }
+
+    //Begin charging time to bookkeeping
+    void start() {
+        current = PHASE_BOOKKEEPING;
+        running = true;
+        if(hardware) hardware->read(counter_mark);
+        mark = Clock::now();
+    }
+
+    void stop() {
+        if(!running) return;
+        charge();
+        running = false;
+    }
+
+    //Charge the time since the last switch and continue in phase, counting a
+    //call of it; returns the phase that was current
+    ProfilePhase enter(ProfilePhase phase) {
+        ProfilePhase previous = current;
+        resume(phase);
+        totals[phase].calls++;
+        return previous;
+    }
+
+    //As enter() without counting a call, to return to an interrupted phase
+    void resume(ProfilePhase phase) {
+        if(running) charge();
+        current = phase;
+    }
+
+    //Shift/rotate and cf_cal nanoseconds measured inside the objective
+    void addEvaluationStages(double shift_rotate, double cf_cal) {
+        shift_rotate_ns += shift_rotate;
+        cf_cal_ns += cf_cal;
+    }
+
+    void clear() {
+        for(Totals& t : totals) t = Totals();
+        shift_rotate_ns = cf_cal_ns = 0.0;
+        running = false;
+    }
+
+    const Totals& get(ProfilePhase phase) const { return totals[phase]; }
+
+    double totalNs() const {
+        double sum = 0.0;
+        for(const Totals& t : totals) sum += t.ns;
+        return sum;
+    }
+
+    //Table of the phases with their share of the total, calls, ns per call and
+    //counters. The objective's stages follow evaluate when they were reported.
+    void report(std::ostream& out, const std::string& label) const {
+        double total = totalNs();
+        out << label << "  total " << std::fixed << std::setprecision(3) << total * 1e-9 << " s" << '\n';
+        out << std::left << std::setw(18) << "phase" << std::right << std::setw(12) << "time(ms)"
+            << std::setw(8) << "share" << std::setw(12) << "calls" << std::setw(10) << "ns/call";
+        if(hardware) {
+            out << std::setw(16) << "cycles" << std::setw(16) << "instructions" << std::setw(8) << "IPC"
+                << std::setw(14) << "LLC misses";
+        }
+        out << '\n';
+
+        for(int p = 0; p < NUM_PHASES; ++p) {
+            const Totals& t = totals[p];
+            row(out, phaseName(static_cast<ProfilePhase>(p)), t.ns, total, t.calls);
+            if(hardware) {
+                const uint64_t* c = t.counters;
+                double ipc = c[HardwareCounters::CYCLES] > 0
+                    ? static_cast<double>(c[HardwareCounters::INSTRUCTIONS]) / c[HardwareCounters::CYCLES] : 0.0;
+                out << std::setw(16) << c[HardwareCounters::CYCLES] << std::setw(16) << c[HardwareCounters::INSTRUCTIONS]
+                    << std::setw(8) << std::setprecision(2) << ipc << std::setw(14) << c[HardwareCounters::LLC_MISSES];
+            }
+            out << '\n';
+
+            if(p == PHASE_EVALUATE && (shift_rotate_ns > 0.0 || cf_cal_ns > 0.0)) {
+                long long calls = t.calls;
+                double base = t.ns - shift_rotate_ns - cf_cal_ns;
+                row(out, "  shift/rotate", shift_rotate_ns, total, calls);
+                out << '\n';
+                row(out, "  base kernel", base > 0.0 ? base : 0.0, total, calls);
+                out << '\n';
+                row(out, "  cf_cal", cf_cal_ns, total, calls);
+                out << '\n';
+            }
+        }
+    }
+
+private:
+    static void row(std::ostream& out, const char* name, double ns, double total, long long calls) {
+        out << std::left << std::setw(18) << name << std::right << std::fixed
+            << std::setw(12) << std::setprecision(3) << ns * 1e-6
+            << std::setw(7) << std::setprecision(1) << (total > 0.0 ? 100.0 * ns / total : 0.0) << "%"
+            << std::setw(12) << calls
+            << std::setw(10) << std::setprecision(1) << (calls > 0 ? ns / calls : 0.0);
+    }
+};
+
+//Charges a scope to phase and returns to the previous phase at its end; a
+//null profiler makes it a no-op
+class ProfileScope {
+    PhaseProfiler* profiler;
+    ProfilePhase previous;
+
+public:
+    ProfileScope(PhaseProfiler* profiler_, ProfilePhase phase) : profiler(profiler_), previous(PHASE_BOOKKEEPING) {
+        if(profiler) previous = profiler->enter(phase);
+    }
+
+    ~ProfileScope() {
+        if(profiler) profiler->resume(previous);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
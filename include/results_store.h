@@ -0,0 +1,546 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <fstream>
+#include <ostream>
+#include <iomanip>
+#include <map>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+//Columnar binary store of raw run results (.chxr). One row per run: suite,
+//optimizer variant, function, dim, run, seed, final error, optimum, FEs used,
+//wall time and an optional convergence curve of curve_length errors at fixed
+//FE ratios. Functions with a name (the basic suite) keep it in a dictionary.
+//
+//Layout (host byte order, every section 8-byte aligned):
+//  header   "CHXRES1\0", u32 version, u32 curve_length, f64 ratios[curve_length]
+//  blocks   up to block_rows rows each, stored column by column:
+//           u8 suite, u8 variant, i32 function, i32 dim, i32 run, u32 seed,
+//           f64 final_error, f64 optimum, i64 FEs, f64 wall_seconds,
+//           f64 curves[rows][curve_length]
+//  footer   u32 suite count, then per suite u32 length + name;
+//           u32 variant count, then per variant u32 length + name;
+//           u32 function name count, then per name u32 suite, i32 function,
+//           u32 length + name (padded);
+//           u64 block count, then per block u64 offset + u64 rows
+//  trailer  u64 footer offset, "CHXEND1\0"
+//Blocks are written as they fill, so a study streams to disk with a
+//bounded buffer; ResultsFile maps the file and reads the columns in place.
+
+struct RunRecord {
+    std::string suite;
+    std::string variant;            //Swarm::variantName()
+    int function;
+    std::string function_name;      //Empty: shown as F<function>
+    int dim;
+    int run;                        //1-based within its (function, dim) cell
+    uint32_t seed;
+    double final_error;             //Best fitness - optimum
+    double optimum;
+    long long FEs;                  //Budget used
+    double wall_seconds;
+    const double* curve;            //curve_length errors, or nullptr (stored as NaN)
+};
+
+namespace results_store {
+    const char HEADER_MAGIC[8] = {'C', 'H', 'X', 'R', 'E', 'S', '1', '\0'};
+    const char TRAILER_MAGIC[8] = {'C', 'H', 'X', 'E', 'N', 'D', '1', '\0'};
+    const uint32_t VERSION = 2;
+    const int COLUMNS = 11;
+
+    inline size_t padded(size_t bytes) { return (bytes + 7) & ~static_cast<size_t>(7); }
+
+    //Bytes of each column of a block of rows, in storage order
+    inline void columnSizes(size_t rows, size_t curve_length, size_t sizes[COLUMNS]) {
+        sizes[0] = padded(rows * sizeof(uint8_t));
+        sizes[1] = padded(rows * sizeof(uint8_t));
+        sizes[2] = padded(rows * sizeof(int32_t));
+        sizes[3] = padded(rows * sizeof(int32_t));
+        sizes[4] = padded(rows * sizeof(int32_t));
+        sizes[5] = padded(rows * sizeof(uint32_t));
+        sizes[6] = rows * sizeof(double);
+        sizes[7] = rows * sizeof(double);
+        sizes[8] = rows * sizeof(int64_t);
+        sizes[9] = rows * sizeof(double);
+        sizes[10] = rows * curve_length * sizeof(double);
+    }
+
+    //Id of name in a string dictionary, adding it if new; false once the
+    //dictionary holds the MAX_NAMES names a u8 column can refer to
+    const size_t MAX_NAMES = 256;
+    inline bool dictionaryId(std::vector<std::string>& names, const std::string& name, uint8_t& id) {
+        for(size_t k = 0; k < names.size(); ++k) {
+            if(names[k] == name) {
+                id = static_cast<uint8_t>(k);
+                return true;
+            }
+        }
+        if(names.size() >= MAX_NAMES) return false;
+        names.push_back(name);
+        id = static_cast<uint8_t>(names.size() - 1);
+        return true;
+    }
+
+    struct FunctionName {
+        uint32_t suite;
+        int32_t function;
+        std::string name;
+    };
+}
+
+//Streaming writer: rows are buffered per column and written a block at a
+//time. close() (or the destructor) writes the last block and the footer.
+class ResultsWriter {
+    std::ofstream out;
+    size_t curve_length;
+    size_t block_rows;
+    uint64_t offset = 0;
+    bool rejected = false;          //A record needed a 257th suite or variant name
+
+    std::vector<std::string> suites;
+    std::vector<std::string> variants;
+    std::vector<results_store::FunctionName> function_names;
+    std::vector<uint64_t> block_offsets;
+    std::vector<uint64_t> block_sizes;
+
+    std::vector<uint8_t> suite, variant;
+    std::vector<int32_t> function, dim, run;
+    std::vector<uint32_t> seed;
+    std::vector<double> final_error, optimum;
+    std::vector<int64_t> FEs;
+    std::vector<double> wall_seconds;
+    std::vector<double> curves;
+
+    void put(const void* data, size_t bytes) {
+        out.write(static_cast<const char*>(data), bytes);
+        offset += bytes;
+    }
+
+    void pad() {
+        static const char zeros[8] = {0};
+        put(zeros, results_store::padded(offset) - offset);
+    }
+
+    template<class T>
+    void column(const std::vector<T>& values) {
+        if(!values.empty()) put(values.data(), values.size() * sizeof(T));
+        pad();
+    }
+
+    void putString(const std::string& s) {
+        uint32_t length = static_cast<uint32_t>(s.size());
+        put(&length, sizeof(length));
+        put(s.data(), s.size());
+    }
+
+    void putDictionary(const std::vector<std::string>& names) {
+        uint32_t count = static_cast<uint32_t>(names.size());
+        put(&count, sizeof(count));
+        for(const std::string& name : names) putString(name);
+    }
+
+    void addFunctionName(uint32_t suite_id, int32_t function_id, const std::string& name) {
+        if(name.empty()) return;
+        for(const results_store::FunctionName& f : function_names) {
+            if(f.suite == suite_id && f.function == function_id) return;
+        }
+        function_names.push_back(results_store::FunctionName{suite_id, function_id, name});
+    }
+
+    void flushBlock() {
+        if(suite.empty()) return;
+        block_offsets.push_back(offset);
+        block_sizes.push_back(suite.size());
+        column(suite);
+        column(variant);
+        column(function);
+        column(dim);
+        column(run);
+        column(seed);
+        column(final_error);
+        column(optimum);
+        column(FEs);
+        column(wall_seconds);
+        column(curves);
+
+        suite.clear();
+        variant.clear();
+        function.clear();
+        dim.clear();
+        run.clear();
+        seed.clear();
+        final_error.clear();
+        optimum.clear();
+        FEs.clear();
+        wall_seconds.clear();
+        curves.clear();
+    }
+
+public:
+    //ratios: FE ratios of the convergence curves (empty for no curves)
+    ResultsWriter(const std::string& path, const std::vector<double>& ratios, size_t block_rows_ = 4096)
+        : out(path, std::ios::binary | std::ios::trunc), curve_length(ratios.size()),
+          block_rows(block_rows_ > 0 ? block_rows_ : 1) {
+        if(!out) return;
+        uint32_t version = results_store::VERSION;
+        uint32_t length = static_cast<uint32_t>(curve_length);
+        put(results_store::HEADER_MAGIC, 8);
+        put(&version, sizeof(version));
+        put(&length, sizeof(length));
+        if(!ratios.empty()) put(ratios.data(), ratios.size() * sizeof(double));
+    }
+
+    ~ResultsWriter() { close(); }
+
+    ResultsWriter(const ResultsWriter&) = delete;
+    ResultsWriter& operator=(const ResultsWriter&) = delete;
+
+    //False if the file could not be written or a record was rejected
+    bool ok() const { return static_cast<bool>(out) && !rejected; }
+    size_t curveLength() const { return curve_length; }
+
+    void append(const RunRecord& r) {
+        if(!out.is_open()) return;
+        uint8_t suite_id, variant_id;
+        if(!results_store::dictionaryId(suites, r.suite, suite_id) ||
+           !results_store::dictionaryId(variants, r.variant, variant_id)) {
+            rejected = true;
+            return;
+        }
+        suite.push_back(suite_id);
+        variant.push_back(variant_id);
+        addFunctionName(suite.back(), r.function, r.function_name);
+        function.push_back(r.function);
+        dim.push_back(r.dim);
+        run.push_back(r.run);
+        seed.push_back(r.seed);
+        final_error.push_back(r.final_error);
+        optimum.push_back(r.optimum);
+        FEs.push_back(r.FEs);
+        wall_seconds.push_back(r.wall_seconds);
+        for(size_t k = 0; k < curve_length; ++k) {
+            curves.push_back(r.curve ? r.curve[k] : std::numeric_limits<double>::quiet_NaN());
+        }
+        if(suite.size() >= block_rows) flushBlock();
+    }
+
+    void close() {
+        if(!out.is_open()) return;
+        flushBlock();
+
+        uint64_t footer = offset;
+        putDictionary(suites);
+        putDictionary(variants);
+        uint32_t num_names = static_cast<uint32_t>(function_names.size());
+        put(&num_names, sizeof(num_names));
+        for(const results_store::FunctionName& f : function_names) {
+            put(&f.suite, sizeof(f.suite));
+            put(&f.function, sizeof(f.function));
+            putString(f.name);
+        }
+        pad();
+        uint64_t num_blocks = block_offsets.size();
+        put(&num_blocks, sizeof(num_blocks));
+        for(size_t b = 0; b < block_offsets.size(); ++b) {
+            put(&block_offsets[b], sizeof(uint64_t));
+            put(&block_sizes[b], sizeof(uint64_t));
+        }
+        put(&footer, sizeof(footer));
+        put(results_store::TRAILER_MAGIC, 8);
+        out.close();
+    }
+};
+
+//Read-only memory map of a .chxr file; columns point into the mapping
+class ResultsFile {
+public:
+    struct Block {
+        size_t rows;
+        const uint8_t* suite;
+        const uint8_t* variant;
+        const int32_t* function;
+        const int32_t* dim;
+        const int32_t* run;
+        const uint32_t* seed;
+        const double* final_error;
+        const double* optimum;
+        const int64_t* FEs;
+        const double* wall_seconds;
+        const double* curves;       //rows x curveLength()
+    };
+
+private:
+    const uint8_t* base = nullptr;
+    size_t length = 0;
+    uint32_t curve_length = 0;
+    const double* ratios = nullptr;
+    std::vector<std::string> suites;
+    std::vector<std::string> variants;
+    std::map<std::pair<uint32_t, int32_t>, std::string> function_names;
+    std::vector<Block> blocks;
+    size_t total_rows = 0;
+
+    bool fail() {
+        close();
+        return false;
+    }
+
+    template<class T>
+    const T* at(size_t pos) const { return reinterpret_cast<const T*>(base + pos); }
+
+    //Scalar at pos; footer entries follow variable-length strings, so copy rather than dereference
+    template<class T>
+    T load(size_t pos) const {
+        T value;
+        std::memcpy(&value, base + pos, sizeof(T));
+        return value;
+    }
+
+    //Length-prefixed string at pos, within the footer
+    bool readString(size_t& pos, std::string& s) const {
+        if(pos + 4 > length - 16) return false;
+        uint32_t n = load<uint32_t>(pos);
+        pos += 4;
+        if(pos + n > length - 16) return false;
+        s.assign(reinterpret_cast<const char*>(base + pos), n);
+        pos += n;
+        return true;
+    }
+
+    bool readDictionary(size_t& pos, std::vector<std::string>& names) const {
+        if(pos + 4 > length - 16) return false;
+        uint32_t count = load<uint32_t>(pos);
+        pos += 4;
+        if(count > results_store::MAX_NAMES) return false;
+        names.resize(count);
+        for(uint32_t k = 0; k < count; ++k) {
+            if(!readString(pos, names[k])) return false;
+        }
+        return true;
+    }
+
+public:
+    ResultsFile() {}
+    ~ResultsFile() { close(); }
+
+    ResultsFile(const ResultsFile&) = delete;
+    ResultsFile& operator=(const ResultsFile&) = delete;
+
+    //Map path and check its structure; false if it is not a complete .chxr file
+    bool open(const std::string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0) return false;
+        struct stat st;
+        if(fstat(fd, &st) != 0 || st.st_size < 32) {
+            ::close(fd);
+            return false;
+        }
+        length = static_cast<size_t>(st.st_size);
+        void* map = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if(map == MAP_FAILED) {
+            length = 0;
+            return false;
+        }
+        base = static_cast<const uint8_t*>(map);
+
+        if(std::memcmp(base, results_store::HEADER_MAGIC, 8) != 0 ||
+           load<uint32_t>(8) != results_store::VERSION ||
+           std::memcmp(base + length - 8, results_store::TRAILER_MAGIC, 8) != 0) {
+            return fail();
+        }
+        curve_length = load<uint32_t>(12);
+        if(16 + curve_length * sizeof(double) > length) return fail();
+        ratios = at<double>(16);
+
+        //Counts and offsets below come from the file: each is bounded by the
+        //mapping before it takes part in any arithmetic
+        const size_t footer = load<uint64_t>(length - 16);
+        if(footer < 16 + curve_length * sizeof(double) || footer > length - 16) return fail();
+        size_t pos = footer;
+        if(!readDictionary(pos, suites) || !readDictionary(pos, variants)) return fail();
+        if(pos + 4 > length - 16) return fail();
+        uint32_t num_names = load<uint32_t>(pos);
+        pos += 4;
+        for(uint32_t k = 0; k < num_names; ++k) {
+            if(pos + 8 > length - 16) return fail();
+            uint32_t suite_id = load<uint32_t>(pos);
+            int32_t function_id = load<int32_t>(pos + 4);
+            pos += 8;
+            if(!readString(pos, function_names[std::make_pair(suite_id, function_id)])) return fail();
+        }
+        pos = results_store::padded(pos);
+        if(pos + 8 > length - 16) return fail();
+        uint64_t num_blocks = load<uint64_t>(pos);
+        pos += 8;
+        if(num_blocks > (length - 16 - pos) / 16) return fail();
+
+        //A row takes at least 8 bytes per f64 column plus its curve
+        const size_t row_bytes = (5 + curve_length) * sizeof(double);
+        for(uint64_t b = 0; b < num_blocks; ++b) {
+            size_t start = load<uint64_t>(pos + 16 * b);
+            size_t rows = load<uint64_t>(pos + 16 * b + 8);
+            if(start % 8 != 0 || start < 16 + curve_length * sizeof(double) || start >= footer ||
+               rows > (footer - start) / row_bytes) {
+                return fail();
+            }
+            size_t sizes[results_store::COLUMNS];
+            results_store::columnSizes(rows, curve_length, sizes);
+            size_t col[results_store::COLUMNS];
+            size_t p = start;
+            for(int c = 0; c < results_store::COLUMNS; ++c) {
+                col[c] = p;
+                p += results_store::padded(sizes[c]);
+            }
+            if(p > footer) return fail();
+            Block block = {rows, at<uint8_t>(col[0]), at<uint8_t>(col[1]), at<int32_t>(col[2]), at<int32_t>(col[3]),
+                           at<int32_t>(col[4]), at<uint32_t>(col[5]), at<double>(col[6]), at<double>(col[7]),
+                           at<int64_t>(col[8]), at<double>(col[9]), at<double>(col[10])};
+            for(size_t r = 0; r < rows; ++r) {
+                if(block.suite[r] >= suites.size() || block.variant[r] >= variants.size()) return fail();
+            }
+            blocks.push_back(block);
+            total_rows += rows;
+        }
+        return true;
+    }
+
+    void close() {
+        if(base) munmap(const_cast<uint8_t*>(base), length);
+        base = nullptr;
+        length = 0;
+        curve_length = 0;
+        ratios = nullptr;
+        suites.clear();
+        variants.clear();
+        function_names.clear();
+        blocks.clear();
+        total_rows = 0;
+    }
+
+    size_t rows() const { return total_rows; }
+    size_t numBlocks() const { return blocks.size(); }
+    const Block& block(size_t b) const { return blocks[b]; }
+    const std::string& suiteName(uint8_t id) const { return suites[id]; }
+    const std::string& variantName(uint8_t id) const { return variants[id]; }
+
+    //Stored name of a function of suite id, or F<function>
+    std::string functionName(uint8_t id, int function) const {
+        std::map<std::pair<uint32_t, int32_t>, std::string>::const_iterator it =
+            function_names.find(std::make_pair(static_cast<uint32_t>(id), static_cast<int32_t>(function)));
+        return it != function_names.end() ? it->second : "F" + std::to_string(function);
+    }
+    size_t curveLength() const { return curve_length; }
+    const double* curveRatios() const { return ratios; }
+};
+
+//Title of a suite in the runners' result files
+inline std::string suiteTitle(const std::string& suite) {
+    if(suite == "basic") return "Basic Benchmark";
+    if(suite == "cec2013") return "CEC 2013";
+    if(suite == "cec2017") return "CEC 2017";
+    return suite;
+}
+
+//Write a store as the text tables of the benchmark runners, with the same
+//banners and separators: per suite and variant, one table per function with
+//a row per dim holding the raw final fitness of each run, then mean, std and
+//mean error (basic suite: mean and std only)
+inline void writeResultsAsText(const ResultsFile& file, std::ostream& out) {
+    struct Cell {
+        std::vector<std::pair<int, double>> runs;   //(run, fitness)
+        double optimum = 0.0;
+    };
+    struct Table {
+        std::map<int, std::map<int, Cell>> functions;   //function -> dim
+        std::map<int, std::string> names;
+    };
+    //(suite, variant) -> table, in first-seen order
+    typedef std::pair<std::string, std::string> Key;
+    std::vector<Key> order;
+    std::map<Key, Table> tables;
+
+    for(size_t b = 0; b < file.numBlocks(); ++b) {
+        const ResultsFile::Block& block = file.block(b);
+        for(size_t r = 0; r < block.rows; ++r) {
+            Key key(file.suiteName(block.suite[r]), file.variantName(block.variant[r]));
+            if(tables.find(key) == tables.end()) order.push_back(key);
+            Table& table = tables[key];
+            int function = block.function[r];
+            if(table.names.find(function) == table.names.end()) {
+                table.names[function] = file.functionName(block.suite[r], function);
+            }
+            Cell& cell = table.functions[function][block.dim[r]];
+            cell.optimum = block.optimum[r];
+            cell.runs.push_back(std::make_pair(block.run[r], block.final_error[r] + block.optimum[r]));
+        }
+    }
+
+    out << std::fixed << std::setprecision(6);
+    for(size_t k = 0; k < order.size(); ++k) {
+        const Key& key = order[k];
+        const Table& table = tables[key];
+        bool with_error = key.first != "basic";
+
+        size_t max_runs = 0;
+        std::vector<int> dims;
+        for(const auto& f : table.functions) {
+            for(const auto& d : f.second) {
+                max_runs = std::max(max_runs, d.second.runs.size());
+                if(std::find(dims.begin(), dims.end(), d.first) == dims.end()) dims.push_back(d.first);
+            }
+        }
+        std::sort(dims.begin(), dims.end());
+
+        if(k) out << '\n';
+        out << "=====================================================" << '\n';
+        out << suiteTitle(key.first) << " Results - " << key.second << " (All Raw Values)" << '\n';
+        out << "All Dimensions: ";
+        for(int d : dims) out << d << "D ";
+        out << '\n';
+        out << "Runs per test: " << max_runs << '\n';
+        out << "=====================================================" << '\n';
+
+        for(const auto& f : table.functions) {
+            if(with_error) {
+                out << "\n\n========== " << table.names.at(f.first) << " ==========" << '\n';
+            } else {
+                out << "\n\n========== Function: " << table.names.at(f.first) << " ==========" << '\n';
+            }
+            out << "Dim\t";
+            for(size_t run = 1; run <= max_runs; run++) out << "Run" << run << "\t\t";
+            if(with_error) {
+                out << "Mean\t\tStd\t\tError" << '\n';
+                out << "-----------------------------------------------------------------------" << '\n';
+            } else {
+                out << "Mean\t\tStd" << '\n';
+                out << "-----------------------------------------------------------" << '\n';
+            }
+
+            for(const auto& d : f.second) {
+                std::vector<std::pair<int, double>> runs = d.second.runs;
+                std::sort(runs.begin(), runs.end());
+                double mean = 0.0, var = 0.0;
+                for(const auto& r : runs) mean += r.second;
+                mean /= runs.size();
+                for(const auto& r : runs) var += (r.second - mean) * (r.second - mean);
+                double std_dev = std::sqrt(var / runs.size());
+
+                out << d.first << "D\t";
+                for(const auto& r : runs) out << r.second << "\t";
+                out << mean << "\t" << std_dev;
+                if(with_error) out << "\t" << mean - d.second.optimum;
+                out << '\n';
+            }
+        }
+    }
+}
@@ -0,0 +1,352 @@
+#pragma once
+#include "island_model.h"
+#include <vector>
+#include <string>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <random>
+#include <functional>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+
+//POSIX shared-memory segment for islands running as separate processes.
+//Layout: a header with the global best fitness, then one record per island
+//holding its status, its own best (seqlock, single writer) and a migration
+//mailbox of elite L vectors (per-slot seqlock, any writer). A worker that
+//dies mid-write can only invalidate its own record or one mailbox slot.
+class ShmIslands {
+public:
+    enum Status { STARTING = 0, RUNNING = 1, FINISHED = 2 };
+
+private:
+    static const uint64_t MAGIC = 0x43485850534f4953ULL;
+
+    struct Header {
+        uint64_t magic;
+        int32_t K;
+        int32_t dim;
+        int32_t slots;
+        int32_t pad;
+        std::atomic<uint64_t> best_bits;    //Global best fitness (bit pattern), CAS-min
+        std::atomic<int32_t> best_owner;    //Hint only: a racing publisher may store it last with a worse fit
+        int32_t pad2;
+    };
+
+    struct RecordHeader {
+        std::atomic<uint32_t> seq;          //Odd while the owner writes its best
+        std::atomic<int32_t> status;
+        std::atomic<int64_t> FEs;
+        std::atomic<uint64_t> write_count;  //Mailbox tickets handed out
+        double best_fit;
+        //followed by double best_x[dim] and the mailbox slots
+    };
+
+    struct SlotHeader {
+        std::atomic<uint32_t> seq;          //Odd while a writer fills the slot
+        uint32_t pad;
+        uint64_t ticket;
+        double fit;
+        //followed by double x[dim]
+    };
+
+    static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2, "shared-memory atomics must be lock-free");
+
+    std::string name;
+    void* base = nullptr;
+    size_t bytes = 0;
+    int K, dim, slots;
+
+    size_t slotBytes() const { return sizeof(SlotHeader) + dim * sizeof(double); }
+    size_t recordBytes() const { return sizeof(RecordHeader) + dim * sizeof(double) + slots * slotBytes(); }
+
+    Header* header() const { return static_cast<Header*>(base); }
+    RecordHeader* record(int i) const {
+        return reinterpret_cast<RecordHeader*>(static_cast<char*>(base) + sizeof(Header) + i * recordBytes());
+    }
+    double* recordX(int i) const { return reinterpret_cast<double*>(record(i) + 1); }
+    SlotHeader* slot(int i, uint64_t ticket) const {
+        char* first = reinterpret_cast<char*>(recordX(i) + dim);
+        return reinterpret_cast<SlotHeader*>(first + (ticket % slots) * slotBytes());
+    }
+
+    static uint64_t toBits(double v) { uint64_t b; std::memcpy(&b, &v, sizeof(b)); return b; }
+    static double fromBits(uint64_t b) { double v; std::memcpy(&v, &b, sizeof(v)); return v; }
+
+public:
+    //Create and initialize the segment (coordinator). Workers inherit the mapping through fork().
+    ShmIslands(const std::string& name_, int K_, int dim_, int slots_ = 16)
+        : name(name_), K(K_), dim(dim_), slots(slots_) {
+        bytes = sizeof(Header) + K * recordBytes();
+
+        shm_unlink(name.c_str());
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if(fd < 0) {
+            std::cerr << "shm_open failed for " << name << std::endl;
+            return;
+        }
+        if(ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            std::cerr << "ftruncate failed for " << name << std::endl;
+            close(fd);
+            return;
+        }
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if(p == MAP_FAILED) {
+            std::cerr << "mmap failed for " << name << std::endl;
+            return;
+        }
+        base = p;
+
+        Header* h = header();
+        h->magic = MAGIC;
+        h->K = K;
+        h->dim = dim;
+        h->slots = slots;
+        new (&h->best_bits) std::atomic<uint64_t>(toBits(std::numeric_limits<double>::infinity()));
+        new (&h->best_owner) std::atomic<int32_t>(-1);
+        for(int i = 0; i < K; ++i) {
+            RecordHeader* r = record(i);
+            new (&r->seq) std::atomic<uint32_t>(0);
+            new (&r->status) std::atomic<int32_t>(STARTING);
+            new (&r->FEs) std::atomic<int64_t>(0);
+            new (&r->write_count) std::atomic<uint64_t>(0);
+            r->best_fit = std::numeric_limits<double>::infinity();
+            for(int s = 0; s < slots; ++s) {
+                SlotHeader* sl = slot(i, s);
+                new (&sl->seq) std::atomic<uint32_t>(0);
+                sl->ticket = UINT64_MAX;
+            }
+        }
+    }
+
+    ~ShmIslands() {
+        if(base) munmap(base, bytes);
+        shm_unlink(name.c_str());
+    }
+
+    bool ok() const { return base != nullptr; }
+
+    //Send a migrant to island i's mailbox. Dropped if its slot is being written.
+    void post(int i, const std::vector<double>& x, double fit) {
+        RecordHeader* r = record(i);
+        uint64_t ticket = r->write_count.fetch_add(1, std::memory_order_relaxed);
+        SlotHeader* sl = slot(i, ticket);
+
+        uint32_t s = sl->seq.load(std::memory_order_relaxed);
+        if((s & 1) || !sl->seq.compare_exchange_strong(s, s + 1, std::memory_order_acquire)) {
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        sl->ticket = ticket;
+        sl->fit = fit;
+        std::memcpy(reinterpret_cast<double*>(sl + 1), x.data(), dim * sizeof(double));
+        sl->seq.store(s + 2, std::memory_order_release);
+    }
+
+    //Read migrants posted to island i since cursor
+    void drain(int i, uint64_t& cursor, std::vector<std::vector<double>>& xs, std::vector<double>& fits) const {
+        RecordHeader* r = record(i);
+        uint64_t end = r->write_count.load(std::memory_order_acquire);
+        if(end > cursor + slots) cursor = end - slots;  //Older entries were overwritten
+
+        std::vector<double> x(dim);
+        for(; cursor < end; ++cursor) {
+            SlotHeader* sl = slot(i, cursor);
+            //Migration is best effort: entries being written (or whose writer
+            //died), dropped and already overwritten are skipped
+            uint32_t s1 = sl->seq.load(std::memory_order_acquire);
+            if(s1 & 1) continue;
+            uint64_t ticket = sl->ticket;
+            double fit = sl->fit;
+            std::memcpy(x.data(), reinterpret_cast<const double*>(sl + 1), dim * sizeof(double));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if(sl->seq.load(std::memory_order_relaxed) != s1) continue;
+            if(ticket != cursor) continue;
+            xs.push_back(x);
+            fits.push_back(fit);
+        }
+    }
+
+    //Publish island i's best (only island i calls this) and offer it as global best
+    void publishBest(int i, const std::vector<double>& x, double fit, long long FEs) {
+        RecordHeader* r = record(i);
+        r->FEs.store(FEs, std::memory_order_relaxed);
+
+        if(!(fit < r->best_fit)) return;
+        uint32_t s = r->seq.load(std::memory_order_relaxed);
+        r->seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        r->best_fit = fit;
+        std::memcpy(recordX(i), x.data(), dim * sizeof(double));
+        r->seq.store(s + 2, std::memory_order_release);
+
+        Header* h = header();
+        uint64_t cur = h->best_bits.load(std::memory_order_relaxed);
+        while(fit < fromBits(cur)) {
+            if(h->best_bits.compare_exchange_weak(cur, toBits(fit), std::memory_order_acq_rel)) {
+                h->best_owner.store(i, std::memory_order_release);
+                break;
+            }
+        }
+    }
+
+    //Consistent copy of island i's best; false if none or a write is in progress
+    bool readIslandBest(int i, std::vector<double>& x, double& fit) const {
+        RecordHeader* r = record(i);
+        uint32_t s1 = r->seq.load(std::memory_order_acquire);
+        if(s1 & 1) return false;
+        x.resize(dim);
+        fit = r->best_fit;
+        std::memcpy(x.data(), recordX(i), dim * sizeof(double));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return r->seq.load(std::memory_order_relaxed) == s1 && fit < std::numeric_limits<double>::infinity();
+    }
+
+    //Best readable solution over all islands: the owner's record when it
+    //holds the global best, else the best intact record
+    bool readGlobalBest(std::vector<double>& x, double& fit) const {
+        int owner = header()->best_owner.load(std::memory_order_acquire);
+        if(owner >= 0 && readIslandBest(owner, x, fit) && fit <= globalBestFitness()) return true;
+        return readBestRecord(x, fit);
+    }
+
+    //Minimum over every intact island record; exact once all workers have exited
+    bool readBestRecord(std::vector<double>& x, double& fit) const {
+        bool found = false;
+        std::vector<double> xi;
+        double fi;
+        for(int i = 0; i < K; ++i) {
+            if(readIslandBest(i, xi, fi) && (!found || fi < fit)) {
+                x = xi;
+                fit = fi;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    double globalBestFitness() const { return fromBits(header()->best_bits.load(std::memory_order_acquire)); }
+
+    void setStatus(int i, Status status) { record(i)->status.store(status, std::memory_order_release); }
+    Status getStatus(int i) const { return static_cast<Status>(record(i)->status.load(std::memory_order_acquire)); }
+    long long getFEs(int i) const { return record(i)->FEs.load(std::memory_order_relaxed); }
+};
+
+//Multi-process island model: a coordinator forks K workers sharing a
+//ShmIslands segment. Each worker builds its own swarm and objective (so
+//CEC data is loaded per process), runs its own ABS schedule, and every
+//migration_interval FEs posts its elites to its neighbours, pulls its
+//mailbox and the global best. A crashed worker is reported and skipped.
+template<class Swarm>
+class ProcessIslandModel {
+    typedef std::function<double(const std::vector<double>&)> Objective;
+
+    int K, N, dim, max_FEs, M;
+    MigrationTopology topology;
+    int migration_interval;
+    int num_migrants;
+    double lb = -100.0, ub = 100.0;
+    std::function<Objective(int)> factory;
+
+    std::vector<double> best;
+    double best_fit = std::numeric_limits<double>::infinity();
+    std::vector<int> crashed;
+
+    void runWorker(ShmIslands& shm, int i) {
+        shm.setStatus(i, ShmIslands::RUNNING);
+        TraceLog::nameThread("island worker " + std::to_string(i));
+        TraceSpan span("island run", "optimizer");
+        std::mt19937 gen(std::random_device{}());
+
+        Swarm swarm(N, dim, max_FEs, M);
+        swarm.setObjective(factory(i));
+        swarm.setBounds(lb, ub);
+        swarm.initialize();
+
+        uint64_t cursor = 0;
+        std::vector<std::vector<double>> xs;
+        std::vector<double> fits;
+        std::vector<double> gx;
+        double gfit;
+        while(swarm.advance(migration_interval)) {
+            TraceSpan migration("migrate", "migration");
+            shm.publishBest(i, swarm.getGBest(), swarm.getGBestFitness(), swarm.getEvaluationStats().FEs);
+
+            swarm.getElites(num_migrants, xs, fits);
+            for(int j : migrationTargets(topology, i, K, gen)) {
+                for(size_t m = 0; m < xs.size(); ++m) shm.post(j, xs[m], fits[m]);
+            }
+
+            xs.clear();
+            fits.clear();
+            shm.drain(i, cursor, xs, fits);
+            for(size_t m = 0; m < xs.size(); ++m) swarm.acceptMigrant(xs[m], fits[m]);
+
+            if(shm.globalBestFitness() < swarm.getGBestFitness() && shm.readGlobalBest(gx, gfit)) {
+                swarm.acceptMigrant(gx, gfit);
+            }
+        }
+
+        shm.publishBest(i, swarm.getGBest(), swarm.getGBestFitness(), swarm.getEvaluationStats().FEs);
+        shm.setStatus(i, ShmIslands::FINISHED);
+    }
+
+public:
+    ProcessIslandModel(int K_, int N_, int dim_, int max_FEs_, int M_,
+                       MigrationTopology topology_ = RING, int migration_interval_ = 1000, int num_migrants_ = 1)
+        : K(K_), N(N_), dim(dim_), max_FEs(max_FEs_), M(M_), topology(topology_),
+          migration_interval(migration_interval_), num_migrants(num_migrants_) {}
+
+    //Called in each worker process after fork() to build its objective
+    void setObjectiveFactory(std::function<Objective(int)> factory_) { factory = factory_; }
+
+    void setBounds(double min_val, double max_val) {
+        lb = min_val;
+        ub = max_val;
+    }
+
+    //Fork the workers and wait for them. Returns false if no worker produced a result.
+    bool run() {
+        std::string name = "/chxpso_islands_" + std::to_string(getpid());
+        ShmIslands shm(name, K, dim);
+        if(!shm.ok()) return false;
+
+        std::cout.flush();
+        std::vector<pid_t> pids(K, -1);
+        for(int i = 0; i < K; ++i) {
+            pid_t pid = fork();
+            if(pid == 0) {
+                TraceLog::beginChildProcess();
+                runWorker(shm, i);
+                TraceLog::endChildProcess();
+                std::cout.flush();
+                _exit(0);
+            }
+            pids[i] = pid;
+        }
+
+        crashed.clear();
+        for(int i = 0; i < K; ++i) {
+            int status = 0;
+            if(pids[i] < 0 || waitpid(pids[i], &status, 0) < 0 ||
+               !WIFEXITED(status) || WEXITSTATUS(status) != 0 ||
+               shm.getStatus(i) != ShmIslands::FINISHED) {
+                crashed.push_back(i);
+            }
+            if(pids[i] > 0) TraceLog::collectChildProcess(pids[i]);
+        }
+
+        return shm.readBestRecord(best, best_fit);
+    }
+
+    const std::vector<int>& getCrashedWorkers() const { return crashed; }
+    double getGBestFitness() { return best_fit; }
+    std::vector<double> getGBest() { return best; }
+};
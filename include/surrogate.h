@@ -0,0 +1,75 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <utility>
+
+//Surrogate model for pre-screening candidates: an archive of past true
+//evaluations and a k-nearest-neighbour inverse-distance-weighted (IDW)
+//predictor. The spread of the neighbours' fitness is the uncertainty.
+class SurrogateModel {
+    size_t capacity;            //Archive size (oldest entries are overwritten)
+    int k;                      //Number of neighbours used per prediction
+    int dim = 0;
+    std::vector<double> X;      //Archived positions, row-major capacity x dim
+    std::vector<double> F;      //Archived fitness values
+    size_t count = 0;
+    size_t head = 0;
+
+    std::vector<std::pair<double, size_t>> neighbours;  //Scratch: (squared distance, index)
+
+public:
+    SurrogateModel(size_t capacity_, int k_)
+        : capacity(capacity_ > 0 ? capacity_ : 1), k(k_ > 0 ? k_ : 1) {}
+
+    void add(const std::vector<double>& x, double fit) {
+        if(dim == 0) {
+            dim = static_cast<int>(x.size());
+            X.resize(capacity * dim);
+            F.resize(capacity);
+        }
+        std::copy(x.begin(), x.end(), X.begin() + head * dim);
+        F[head] = fit;
+        head = (head + 1) % capacity;
+        if(count < capacity) count++;
+    }
+
+    //True once there are enough samples for a prediction
+    bool ready() const { return count >= static_cast<size_t>(k); }
+
+    //Predict fitness at x: IDW mean and weighted standard deviation of the neighbours
+    void predict(const std::vector<double>& x, double& mean, double& sigma) {
+        neighbours.clear();
+        for(size_t i = 0; i < count; ++i) {
+            const double* xi = &X[i * dim];
+            double d2 = 0.0;
+            for(int d = 0; d < dim; ++d) {
+                double diff = x[d] - xi[d];
+                d2 += diff * diff;
+            }
+            neighbours.push_back(std::make_pair(d2, i));
+        }
+
+        size_t kk = std::min(static_cast<size_t>(k), neighbours.size());
+        std::partial_sort(neighbours.begin(), neighbours.begin() + kk, neighbours.end());
+
+        double w_sum = 0.0;
+        mean = 0.0;
+        for(size_t j = 0; j < kk; ++j) {
+            double w = 1.0 / (neighbours[j].first + 1e-12);
+            mean += w * F[neighbours[j].second];
+            w_sum += w;
+        }
+        mean /= w_sum;
+
+        double var = 0.0;
+        for(size_t j = 0; j < kk; ++j) {
+            double w = 1.0 / (neighbours[j].first + 1e-12);
+            double diff = F[neighbours[j].second] - mean;
+            var += w * diff * diff;
+        }
+        sigma = std::sqrt(var / w_sum);
+    }
+
+    size_t size() const { return count; }
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include "particle.h"
+#include <algorithm>
+
+//Policies combined at compile time by CHxPSO<Real, Exemplar, Update, Schedule, Boundary>.
+//They are plain classes whose members are called directly (no virtual
+//dispatch), so each variant's update loop is inlined and vectorized as one
+//kernel. An exemplar policy is a friend of the swarm and may read its state.
+
+//Linearly decreasing inertia and acceleration coefficients (paper defaults)
+struct LinearSchedule {
+    double w_init = 0.99, w_final = 0.2;
+    double c_init = 3.0, c_final = 1.5;     //Er channel
+    double c1_init = 2.5, c1_final = 0.5;   //Ei channel
+
+    static double linear(double init, double final, int current_FEs, int max_FEs) {
+        return init - (init - final) * static_cast<double>(current_FEs) / max_FEs;
+    }
+
+    //w and the acceleration coefficient for moving the particle of role
+    void coefficients(Role role, int current_FEs, int max_FEs, double& w, double& c) const {
+        w = linear(w_init, w_final, current_FEs, max_FEs);
+        if(role == ER) {
+            c = linear(c_init, c_final, current_FEs, max_FEs);
+        } else {
+            c = linear(c1_init, c1_final, current_FEs, max_FEs);
+        }
+    }
+};
+
+//Er channel, equation (5): towards Q. Ei channel, equation (6): towards (Q + gbest) / 2.
+struct StandardUpdate {
+    template<bool Ei, class Real>
+    static Real velocity(Real v, Real x, Real q, Real g, Real r, Real w, Real c) {
+        Real target = Ei ? (q + g) / Real(2) : q;
+        return w * v + c * r * (target - x);
+    }
+};
+
+//Clamp the position to the box and stop the particle there
+struct ClampBoundary {
+    template<class Real>
+    static void apply(Real& x, Real& v, Real x_min, Real x_max) {
+        if(x < x_min) {
+            x = x_min;
+            v = 0;
+        }
+        if(x > x_max) {
+            x = x_max;
+            v = 0;
+        }
+    }
+};
+
+//Q = L: cognitive-only exemplar (CHpPSO-ABS)
+struct OwnBestExemplar {
+    static const char* name() { return "CHpPSO-ABS"; }
+
+    template<class Swarm>
+    void construct(Swarm& swarm, int layer_idx) {
+        swarm.layers[layer_idx].Q = swarm.layers[layer_idx].L;
+    }
+    
+    void reset() {}
+};
@@ -0,0 +1,40 @@
+#pragma once
+#include <vector>
+#include <memory>
+
+//Keeps optimizer instances alive across runs and cells. acquire() hands out
+//an idle instance of the requested shape after reset(seed), constructing one
+//only when none is idle, so repeated short runs reuse warm swarm memory
+//instead of reallocating every Layer vector. Not thread-safe.
+template<class Swarm>
+class SwarmPool {
+    std::vector<std::unique_ptr<Swarm>> swarms;
+    std::vector<char> in_use;
+
+public:
+    Swarm& acquire(int N, int dim, int max_FEs, int M, unsigned int seed) {
+        for(size_t i = 0; i < swarms.size(); ++i) {
+            if(!in_use[i] && swarms[i]->hasShape(N, dim, max_FEs, M)) {
+                in_use[i] = 1;
+                swarms[i]->reset(seed);
+                return *swarms[i];
+            }
+        }
+        swarms.emplace_back(new Swarm(N, dim, max_FEs, M));
+        in_use.push_back(1);
+        swarms.back()->seed(seed);
+        return *swarms.back();
+    }
+
+    void release(Swarm& swarm) {
+        for(size_t i = 0; i < swarms.size(); ++i) {
+            if(swarms[i].get() == &swarm) {
+                in_use[i] = 0;
+                return;
+            }
+        }
+    }
+
+    //Instances constructed so far
+    size_t size() const { return swarms.size(); }
+};
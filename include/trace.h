@@ -0,0 +1,260 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <string>
+#include <ostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <unistd.h>
+
+//Timeline tracing in the Chrome Trace Event format (open the file in
+//Perfetto or chrome://tracing). Off by default; TraceLog::enable() turns it
+//on process-wide. Every thread appends to its own chunked buffer, registered
+//once under a lock, so recording never locks or waits on other threads.
+//Buffers are merged and written once at the end with TraceLog::write().
+
+enum TraceLevel {
+    TRACE_OFF,
+    TRACE_RUNS,             //Cells, runs, migrations
+    TRACE_EVALUATIONS       //Also every objective call (large traces)
+};
+
+struct TraceEvent {
+    const char* name;       //Static strings only
+    const char* cat;
+    char ph;                //'X' span, 'i' instant
+    int64_t ts;             //ns since enable()
+    int64_t dur;
+    char detail[48];        //Optional args.detail, truncated
+};
+
+//Events of one thread; only that thread appends
+class TraceBuffer {
+    static const size_t CHUNK = 4096;
+    std::vector<std::unique_ptr<TraceEvent[]>> chunks;
+    size_t count = 0;
+
+public:
+    int tid;
+    std::string thread_name;
+
+    explicit TraceBuffer(int tid_) : tid(tid_) {}
+
+    TraceEvent& append() {
+        if(count == chunks.size() * CHUNK) chunks.emplace_back(new TraceEvent[CHUNK]);
+        TraceEvent& e = chunks[count / CHUNK][count % CHUNK];
+        count++;
+        return e;
+    }
+
+    size_t size() const { return count; }
+    const TraceEvent& operator[](size_t k) const { return chunks[k / CHUNK][k % CHUNK]; }
+    void clear() { count = 0; }
+};
+
+class TraceLog {
+    typedef std::chrono::steady_clock Clock;
+
+    struct State {
+        std::atomic<int> level{TRACE_OFF};
+        Clock::time_point epoch;
+        std::mutex mtx;                                     //Registration and write only
+        std::vector<std::unique_ptr<TraceBuffer>> buffers;
+        std::vector<std::string> fragments;                 //Events of finished child processes
+        std::string path;
+    };
+
+    static State& state() {
+        static State s;
+        return s;
+    }
+
+    static TraceBuffer& threadBuffer() {
+        thread_local TraceBuffer* buffer = nullptr;
+        if(!buffer) {
+            State& s = state();
+            std::lock_guard<std::mutex> lock(s.mtx);
+            s.buffers.emplace_back(new TraceBuffer(static_cast<int>(s.buffers.size())));
+            buffer = s.buffers.back().get();
+        }
+        return *buffer;
+    }
+
+    static void escape(std::ostream& out, const char* text) {
+        for(const char* c = text; *c; ++c) {
+            if(*c == '"' || *c == '\\') out << '\\';
+            if(static_cast<unsigned char>(*c) >= 0x20) out << *c;
+        }
+    }
+
+    static void writeEvents(std::ostream& out, bool& first) {
+        State& s = state();
+        int pid = static_cast<int>(getpid());
+        char number[32];
+        for(const std::unique_ptr<TraceBuffer>& b : s.buffers) {
+            if(!b->thread_name.empty()) {
+                out << (first ? "\n" : ",\n");
+                first = false;
+                out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << b->tid
+                    << ",\"args\":{\"name\":\"";
+                escape(out, b->thread_name.c_str());
+                out << "\"}}";
+            }
+            for(size_t k = 0; k < b->size(); ++k) {
+                const TraceEvent& e = (*b)[k];
+                out << (first ? "\n" : ",\n");
+                first = false;
+                out << "{\"name\":\"" << e.name << "\",\"cat\":\"" << e.cat << "\",\"ph\":\"" << e.ph << "\"";
+                std::snprintf(number, sizeof(number), "%.3f", e.ts * 1e-3);
+                out << ",\"ts\":" << number;
+                if(e.ph == 'X') {
+                    std::snprintf(number, sizeof(number), "%.3f", e.dur * 1e-3);
+                    out << ",\"dur\":" << number;
+                } else {
+                    out << ",\"s\":\"t\"";
+                }
+                out << ",\"pid\":" << pid << ",\"tid\":" << b->tid;
+                if(e.detail[0]) {
+                    out << ",\"args\":{\"detail\":\"";
+                    escape(out, e.detail);
+                    out << "\"}";
+                }
+                out << "}";
+            }
+        }
+    }
+
+public:
+    //Start recording at level; path is used for the fragments of child processes
+    static void enable(TraceLevel level, const std::string& path) {
+        State& s = state();
+        s.epoch = Clock::now();
+        s.path = path;
+        s.level.store(level, std::memory_order_release);
+    }
+
+    static bool active(TraceLevel level) {
+        int current = state().level.load(std::memory_order_relaxed);
+        return current != TRACE_OFF && level <= current;
+    }
+
+    static int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - state().epoch).count();
+    }
+
+    //Label the calling thread's track
+    static void nameThread(const std::string& name) {
+        if(!active(TRACE_RUNS)) return;
+        threadBuffer().thread_name = name;
+    }
+
+    static void record(char ph, const char* name, const char* cat, int64_t ts, int64_t dur, const char* detail) {
+        TraceEvent& e = threadBuffer().append();
+        e.name = name;
+        e.cat = cat;
+        e.ph = ph;
+        e.ts = ts;
+        e.dur = dur;
+        e.detail[0] = '\0';
+        if(detail) {
+            std::strncpy(e.detail, detail, sizeof(e.detail) - 1);
+            e.detail[sizeof(e.detail) - 1] = '\0';
+        }
+    }
+
+    static void instant(const char* name, const char* cat, const char* detail = nullptr,
+                        TraceLevel level = TRACE_RUNS) {
+        if(!active(level)) return;
+        record('i', name, cat, now(), 0, detail);
+    }
+
+    //---- Child processes (fork) ----
+
+    //In a child after fork(): drop the events inherited from the parent
+    static void beginChildProcess() {
+        State& s = state();
+        for(std::unique_ptr<TraceBuffer>& b : s.buffers) {
+            b->clear();
+            b->thread_name.clear();
+        }
+        s.fragments.clear();
+    }
+
+    //In a child before it exits: save its events for the parent
+    static void endChildProcess() {
+        if(!active(TRACE_RUNS)) return;
+        std::ofstream out(fragmentPath(getpid()));
+        bool first = true;
+        writeEvents(out, first);
+    }
+
+    //In the parent once child pid has exited: take over its saved events
+    static void collectChildProcess(int pid) {
+        if(!active(TRACE_RUNS)) return;
+        std::string path = fragmentPath(pid);
+        std::ifstream in(path);
+        if(!in) return;
+        std::stringstream text;
+        text << in.rdbuf();
+        in.close();
+        std::remove(path.c_str());
+        State& s = state();
+        std::lock_guard<std::mutex> lock(s.mtx);
+        if(!text.str().empty()) s.fragments.push_back(text.str());
+    }
+
+    static std::string fragmentPath(int pid) {
+        return state().path + "." + std::to_string(pid) + ".part";
+    }
+
+    //Write all recorded events as one trace. Call once recording threads are done.
+    static void write(std::ostream& out) {
+        State& s = state();
+        std::lock_guard<std::mutex> lock(s.mtx);
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        writeEvents(out, first);
+        for(const std::string& fragment : s.fragments) {
+            out << (first ? "" : ",") << fragment;
+            first = false;
+        }
+        out << "\n]}\n";
+    }
+};
+
+//Records the enclosing scope as a span when tracing at level is on
+class TraceSpan {
+    const char* name;
+    const char* cat;
+    int64_t start;
+    char detail[sizeof(TraceEvent::detail)];
+
+public:
+    TraceSpan(const char* name_, const char* cat_, TraceLevel level = TRACE_RUNS, const char* detail_ = nullptr)
+        : name(nullptr), cat(cat_), start(0) {
+        if(!TraceLog::active(level)) return;
+        name = name_;
+        detail[0] = '\0';
+        if(detail_) {
+            std::strncpy(detail, detail_, sizeof(detail) - 1);
+            detail[sizeof(detail) - 1] = '\0';
+        }
+        start = TraceLog::now();
+    }
+
+    TraceSpan(const char* name_, const char* cat_, const std::string& detail_)
+        : TraceSpan(name_, cat_, TRACE_RUNS, detail_.c_str()) {}
+
+    ~TraceSpan() {
+        if(name) TraceLog::record('X', name, cat, start, TraceLog::now() - start, detail);
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
@@ -1,43 +1,128 @@
 #pragma once
 #include "chxpso_abs.h"
 #include <vector>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <algorithm>
 
-//CHCLPSO-ABS: CLPSO with Comprehensive Learning and ABS
-class CHCLPSO_ABS : public CHxPSO_ABS {
-private:
+//Comprehensive learning exemplar: each dimension of Q is taken from a random
+//exemplar (a layer's L vector or a migrant) with probability Pc, else from own L
+struct ComprehensiveLearning {
     double Pc_init = 0.05;
     double Pc_final = 0.5;
-    std::vector<std::vector<int>> learning_source;  //Which layer each dimension learns from
     
-    double getPc() {
-        //Pc increases linearly: 0.05 -> 0.5
-        return Pc_init + (Pc_final - Pc_init) * static_cast<double>(FEs) / max_FEs;
+    //Learning-source diagnostics, off by default: the exemplar (layer, or
+    //>= N: migrant) each dimension of Q was taken from, N x dim row-major.
+    //Stored as uint16 while every pool index fits, otherwise int32.
+    bool track_sources = false;
+    int dim = 0;
+    std::vector<uint16_t> source16;
+    std::vector<int32_t> source32;
+    
+    static const char* name() { return "CHCLPSO-ABS"; }
+    
+    //Default Pc schedule, tracking off; buffers keep their capacity
+    void reset() {
+        Pc_init = 0.05;
+        Pc_final = 0.5;
+        track_sources = false;
+        dim = 0;
+        source16.clear();
+        source32.clear();
     }
     
-public:
-    CHCLPSO_ABS(int N_, int dim_, int max_FEs_, int M_)
-        : CHxPSO_ABS(N_, dim_, max_FEs_, M_) {
-        learning_source.resize(N, std::vector<int>(dim, 0));
+    void enableTracking(int N, int dim_, int max_pool) {
+        track_sources = true;
+        dim = dim_;
+        size_t size = static_cast<size_t>(N) * dim;
+        if(max_pool - 1 <= UINT16_MAX) {
+            source16.assign(size, 0);
+            source32.clear();
+        } else {
+            source32.assign(size, 0);
+            source16.clear();
+        }
     }
     
-    //Override constructQ: use CL strategy
-    void constructQ(int layer_idx) override {
-        Layer& layer = layers[layer_idx];
-        double Pc = getPc();
+    int source(int layer_idx, int d) const {
+        size_t k = static_cast<size_t>(layer_idx) * dim + d;
+        return source32.empty() ? source16[k] : source32[k];
+    }
+    
+    void recordSource(int layer_idx, int d, int src) {
+        size_t k = static_cast<size_t>(layer_idx) * dim + d;
+        if(!source32.empty()) {
+            source32[k] = src;
+            return;
+        }
+        if(src > UINT16_MAX) {
+            //Pool outgrew uint16 (many migrants): widen once
+            source32.assign(source16.begin(), source16.end());
+            source16.clear();
+            source16.shrink_to_fit();
+            source32[k] = src;
+            return;
+        }
+        source16[k] = static_cast<uint16_t>(src);
+    }
+    
+    //Q = L, then only the learning dimensions are visited: the gap to the next
+    //one is geometric with parameter Pc (inverse CDF of one uniform), which
+    //gives the same independent Bernoulli(Pc) choice per dimension as testing
+    //each one, with about 2 * Pc * dim draws instead of (1 + Pc) * dim. Each
+    //learned coordinate is copied as it is drawn: its draws (a log and a
+    //uniform) dominate, so a batched gather of the copies gains nothing.
+    template<class Swarm>
+    void construct(Swarm& swarm, int layer_idx) {
+        auto& layer = swarm.layers[layer_idx];
+        int n = swarm.dim;
         
-        for(int d = 0; d < dim; ++d) {
-            if(dis(gen) < Pc) {
-                //Learn from a random layer's L vector
-                int random_layer = static_cast<int>(dis(gen) * N);
-                if(random_layer >= N) random_layer = N - 1;
-                
-                layer.Q[d] = layers[random_layer].L[d];
-                learning_source[layer_idx][d] = random_layer;
-            } else {
-                //Learn from own L vector
-                layer.Q[d] = layer.L[d];
-                learning_source[layer_idx][d] = layer_idx;
-            }
+        //Pc increases linearly: 0.05 -> 0.5
+        double Pc = Pc_init + (Pc_final - Pc_init) * static_cast<double>(swarm.FEs) / swarm.max_FEs;
+        
+        //Learn from own L vector by default
+        std::copy(layer.L.begin(), layer.L.end(), layer.Q.begin());
+        if(track_sources) {
+            for(int d = 0; d < n; ++d) recordSource(layer_idx, d, layer_idx);
+        }
+        if(Pc <= 0.0) return;
+        
+        //Learn from a random layer's L vector (or a migrant's, see acceptMigrant)
+        int pool = swarm.exemplarPoolSize();
+        double log_miss = Pc < 1.0 ? std::log(1.0 - Pc) : -std::numeric_limits<double>::infinity();
+        for(double d = -1.0;;) {
+            d += 1.0 + std::floor(std::log(1.0 - swarm.dis(swarm.gen)) / log_miss);
+            if(!(d < n)) break;
+            
+            int random_layer = static_cast<int>(swarm.dis(swarm.gen) * pool);
+            if(random_layer >= pool) random_layer = pool - 1;
+            
+            int k = static_cast<int>(d);
+            layer.Q[k] = swarm.exemplar(random_layer)[k];
+            if(track_sources) recordSource(layer_idx, k, random_layer);
         }
     }
-};
\ No newline at end of file
+};
+
+//CHCLPSO-ABS: CLPSO with Comprehensive Learning and ABS
+template<class Real>
+class CHCLPSO_ABS_T : public CHxPSO<Real, ComprehensiveLearning> {
+    typedef CHxPSO<Real, ComprehensiveLearning> Base;
+    
+public:
+    CHCLPSO_ABS_T(int N_, int dim_, int max_FEs_, int M_)
+        : Base(N_, dim_, max_FEs_, M_) {}
+    
+    //Record the learning source of every Q dimension from now on
+    void enableLearningSourceTracking() {
+        this->exemplar_policy.enableTracking(this->N, this->dim, this->N + this->max_migrants);
+    }
+    
+    //Exemplar Q[d] of layer layer_idx was last taken from (tracking must be enabled)
+    int getLearningSource(int layer_idx, int d) const {
+        return this->exemplar_policy.source(layer_idx, d);
+    }
+};
+
+typedef CHCLPSO_ABS_T<double> CHCLPSO_ABS;
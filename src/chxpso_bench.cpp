@@ -0,0 +1,461 @@
+//Microbenchmarks: ns per call of the optimizer kernels, the basic functions
+//and every CEC 2013/2017 function, and pure optimizer overhead with a null
+//objective. Each case is calibrated to at least --min-ms per trial (the
+//calibration doubles as warmup) and repeated --trials times on a pinned CPU;
+//median, min and max ns per call are reported.
+//
+//With --save-baseline / --compare the timings, plus the final error of
+//seeded runs of every function, are stored as or checked against a baseline
+//(see perf_baseline.h); the exit status flags speed and quality regressions.
+#include "variant_factory.h"
+#include "benchmarks.h"
+#include "lockstep_runner.h"
+#include "perf_baseline.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <cstdlib>
+#include <cstdio>
+#include <unistd.h>
+#include <sched.h>
+
+struct BenchOptions {
+    int trials = 7;
+    double min_ms = 20.0;               //Minimum duration of one trial
+    int cpu = 0;                        //-1: do not pin
+    std::string filter;                 //Substring of "group/name"
+    std::string variant = "chclpso";
+    std::vector<int> dims = {10, 30, 50, 100};
+    bool null_only = false;
+
+    //Baseline mode
+    std::string save_baseline, compare_baseline;
+    int quality_runs = 10;              //Seeded runs per function for the error statistics
+    int quality_fes = 2000;             //Budget of those runs: quality_fes * dim
+    RegressionThresholds thresholds;
+
+    bool baselineMode() const { return !save_baseline.empty() || !compare_baseline.empty(); }
+};
+
+struct BenchResult {
+    std::string group, name;
+    int dim;
+    double median_ns, min_ns, max_ns;   //Per call
+    long long calls;                    //Per trial
+    std::vector<double> samples;        //ns per call of every trial
+};
+
+struct BenchRecords {
+    std::vector<BenchResult> timings;
+    std::vector<BaselineEntry> quality; //Final error per (function, dim)
+};
+
+static volatile double sink;            //Keeps results alive
+
+double elapsedNs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+//Time body(n) (n calls of the case) over opt.trials trials
+BenchResult measure(const std::string& group, const std::string& name, int dim,
+                    const std::function<void(long long)>& body, const BenchOptions& opt) {
+    long long n = 1;
+    for(;;) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        body(n);
+        if(elapsedNs(start) >= opt.min_ms * 1e6 || n >= (1LL << 40)) break;
+        n *= 2;
+    }
+
+    std::vector<double> per_call;
+    for(int t = 0; t < opt.trials; ++t) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        body(n);
+        per_call.push_back(elapsedNs(start) / n);
+    }
+    std::sort(per_call.begin(), per_call.end());
+
+    BenchResult r = {group, name, dim, per_call[per_call.size() / 2], per_call.front(), per_call.back(), n, per_call};
+    return r;
+}
+
+bool selected(const BenchOptions& opt, const std::string& group, const std::string& name) {
+    return opt.filter.empty() || (group + "/" + name).find(opt.filter) != std::string::npos;
+}
+
+void printHeader() {
+    std::cout << std::left << std::setw(10) << "group" << std::setw(22) << "case" << std::right
+              << std::setw(6) << "dim" << std::setw(14) << "median ns" << std::setw(14) << "min ns"
+              << std::setw(14) << "max ns" << std::setw(14) << "calls/trial" << std::endl;
+}
+
+void printResult(const BenchResult& r) {
+    std::cout << std::left << std::setw(10) << r.group << std::setw(22) << r.name << std::right
+              << std::setw(6) << r.dim << std::fixed << std::setprecision(1)
+              << std::setw(14) << r.median_ns << std::setw(14) << r.min_ns << std::setw(14) << r.max_ns
+              << std::setw(14) << r.calls << std::endl;
+}
+
+//Points spread over [lb, ub]^dim, cycled through by the function benchmarks
+std::vector<double> randomPoints(int count, int dim, double lb, double ub, unsigned int seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dis(lb, ub);
+    std::vector<double> X(static_cast<size_t>(count) * dim);
+    for(double& v : X) v = dis(gen);
+    return X;
+}
+
+const int NUM_POINTS = 64;
+
+//Swarm with access to the per-layer ABS selection, primed mid-run so Q,
+//gbest and the counters hold realistic values
+template<class Swarm>
+class KernelSwarm : public Swarm {
+public:
+    KernelSwarm(int N, int dim, int max_FEs, int M) : Swarm(N, dim, max_FEs, M) {
+        this->seed(12345);
+        this->setObjective(sphere);
+        this->setBounds(-100.0, 100.0);
+        this->initialize();
+        this->advance(max_FEs / 2);
+        this->abs.calculateThresholds(this->FEs, this->max_FEs, this->M_Er, this->M_Ei);
+    }
+
+    int select(int n) { return this->abs.selectParticle(this->layers[n], this->M_Er, this->M_Ei); }
+};
+
+template<class Swarm>
+void benchKernels(const BenchOptions& opt, BenchRecords& records) {
+    const int N = 20, M = 6;
+    for(int dim : opt.dims) {
+        KernelSwarm<Swarm> swarm(N, dim, 10000 * dim, M);
+
+        if(selected(opt, "kernel", "updateErChannel")) {
+            records.timings.push_back(measure("kernel", "updateErChannel", dim, [&swarm, N](long long n) {
+                for(long long i = 0; i < n; ++i) swarm.updateErChannel(static_cast<int>(i % N));
+            }, opt));
+            printResult(records.timings.back());
+        }
+        if(selected(opt, "kernel", "updateEiChannel")) {
+            records.timings.push_back(measure("kernel", "updateEiChannel", dim, [&swarm, N](long long n) {
+                for(long long i = 0; i < n; ++i) swarm.updateEiChannel(static_cast<int>(i % N));
+            }, opt));
+            printResult(records.timings.back());
+        }
+        if(selected(opt, "kernel", "constructQ")) {
+            records.timings.push_back(measure("kernel", "constructQ", dim, [&swarm, N](long long n) {
+                for(long long i = 0; i < n; ++i) swarm.constructQ(static_cast<int>(i % N));
+            }, opt));
+            printResult(records.timings.back());
+        }
+        if(selected(opt, "kernel", "selectParticle")) {
+            records.timings.push_back(measure("kernel", "selectParticle", dim, [&swarm, N](long long n) {
+                int sum = 0;
+                for(long long i = 0; i < n; ++i) sum += swarm.select(static_cast<int>(i % N));
+                sink = sum;
+            }, opt));
+            printResult(records.timings.back());
+        }
+    }
+}
+
+//Final error of runs with seeds 1..quality_runs of one (function, dim) cell,
+//advanced in lockstep
+template<class Swarm>
+void measureQuality(const std::string& group, const std::string& name, int dim, double lb, double ub,
+                    double optimum, const BatchObjective& objective, const BenchOptions& opt, BenchRecords& records) {
+    const int N = 20, M = 6;
+    int max_FEs = opt.quality_fes * dim;
+    std::vector<unsigned int> seeds;
+    for(int r = 1; r <= opt.quality_runs; ++r) seeds.push_back(r);
+
+    LockstepRunner<Swarm> runs(opt.quality_runs, N, dim, max_FEs, M, seeds);
+    runs.setBounds(lb, ub);
+    runs.setBatchObjective(objective);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    runs.run();
+    double seconds = elapsedNs(start) * 1e-9;
+
+    std::vector<double> errors;
+    for(int r = 0; r < runs.size(); ++r) errors.push_back(runs.getRun(r).getGBestFitness() - optimum);
+    records.quality.push_back(summarize(group, name, dim, "error", errors));
+
+    const BaselineEntry& e = records.quality.back();
+    std::cout << std::setw(38) << "" << "error " << std::scientific << std::setprecision(4) << e.mean
+              << " +- " << e.stddev << " (" << e.n << " runs, " << std::fixed << std::setprecision(0)
+              << opt.quality_runs * static_cast<double>(max_FEs) / seconds << " FEs/s)" << std::endl;
+}
+
+struct BasicFunction {
+    const char* name;
+    double (*f)(const std::vector<double>&);
+    double bound;
+};
+
+const BasicFunction BASIC_FUNCTIONS[] = {
+    {"sphere", sphere, 100.0}, {"rastrigin", rastrigin, 5.12},
+    {"rosenbrock", rosenbrock, 30.0}, {"ackley", ackley, 32.0}
+};
+
+template<class Swarm>
+void benchBasicFunctions(const BenchOptions& opt, BenchRecords& records) {
+    for(const BasicFunction& fn : BASIC_FUNCTIONS) {
+        if(!selected(opt, "basic", fn.name)) continue;
+        for(int dim : opt.dims) {
+            std::vector<double> X = randomPoints(NUM_POINTS, dim, -fn.bound, fn.bound, 7);
+            std::vector<std::vector<double>> points;
+            for(int k = 0; k < NUM_POINTS; ++k) {
+                points.push_back(std::vector<double>(X.begin() + k * dim, X.begin() + (k + 1) * dim));
+            }
+            double (*f)(const std::vector<double>&) = fn.f;
+            records.timings.push_back(measure("basic", fn.name, dim, [&points, f](long long n) {
+                double sum = 0.0;
+                for(long long i = 0; i < n; ++i) sum += f(points[i % NUM_POINTS]);
+                sink = sum;
+            }, opt));
+            printResult(records.timings.back());
+
+            if(opt.baselineMode()) {
+                measureQuality<Swarm>("basic", fn.name, dim, -fn.bound, fn.bound, 0.0,
+                                      [f, dim](const double* X, int m, double* F) {
+                    std::vector<double> x(dim);
+                    for(int i = 0; i < m; ++i) {
+                        x.assign(X + static_cast<size_t>(i) * dim, X + static_cast<size_t>(i + 1) * dim);
+                        F[i] = f(x);
+                    }
+                }, opt, records);
+            }
+        }
+    }
+}
+
+//Every function of a CEC suite, one point per call through evaluateBatch
+//(no per-call allocation). Runs inside the suite's directory for input_data.
+template<class Swarm, class Benchmark>
+void benchCECSuite(const char* group, const char* dir, int num_functions,
+                   const BenchOptions& opt, BenchRecords& records) {
+    char original_dir[1024];
+    if(!getcwd(original_dir, sizeof(original_dir)) || chdir(dir) != 0) {
+        std::cout << "  (" << dir << "/ not found, skipping " << group << ")" << std::endl;
+        return;
+    }
+
+    for(int func = 1; func <= num_functions; ++func) {
+        std::string name = "F" + std::to_string(func);
+        if(!selected(opt, group, name)) continue;
+        for(int dim : opt.dims) {
+            if(!Benchmark::isDefined(func, dim)) {
+                std::cout << "  (" << group << "/" << name << " not defined for D=" << dim << ")" << std::endl;
+                continue;
+            }
+            double lb, ub;
+            Benchmark::getBounds(func, lb, ub);
+            std::vector<double> X = randomPoints(NUM_POINTS, dim, lb, ub, 11);
+            Benchmark benchmark(func, dim);
+            records.timings.push_back(measure(group, name, dim, [&benchmark, &X, dim](long long n) {
+                double sum = 0.0, f;
+                for(long long i = 0; i < n; ++i) {
+                    benchmark.evaluateBatch(X.data() + (i % NUM_POINTS) * dim, 1, &f);
+                    sum += f;
+                }
+                sink = sum;
+            }, opt));
+            printResult(records.timings.back());
+
+            if(opt.baselineMode()) {
+                measureQuality<Swarm>(group, name, dim, lb, ub, Benchmark::getOptimalValue(func),
+                                      [&benchmark](const double* X, int m, double* F) {
+                    benchmark.evaluateBatch(X, m, F);
+                }, opt, records);
+            }
+        }
+    }
+
+    if(chdir(original_dir) != 0) std::cout << "  (cannot return to " << original_dir << ")" << std::endl;
+}
+
+//Whole runs against an O(1) objective (the first coordinate): the time per
+//FE is the optimizer's own overhead. Reported as ns per FE and FEs per second.
+template<class Swarm>
+void benchNullObjective(const BenchOptions& opt, BenchRecords& records) {
+    const int N = 20, M = 6;
+    for(int dim : opt.dims) {
+        if(!selected(opt, "null", Swarm::variantName())) continue;
+        int max_FEs = 1000 * dim;
+        unsigned int seed = 1;
+        Swarm swarm(N, dim, max_FEs, M);
+        BenchResult r = measure("null", Swarm::variantName(), dim, [&](long long n) {
+            for(long long i = 0; i < n; ++i) {
+                swarm.reset(seed++);
+                swarm.setObjective([](const std::vector<double>& x) { return x[0]; });
+                swarm.run();
+            }
+        }, opt);
+        r.median_ns /= max_FEs;
+        r.min_ns /= max_FEs;
+        r.max_ns /= max_FEs;
+        r.calls *= max_FEs;
+        for(double& t : r.samples) t /= max_FEs;
+        records.timings.push_back(r);
+        printResult(r);
+        std::cout << std::setw(38) << "" << std::fixed << std::setprecision(0) << 1e9 / r.median_ns
+                  << " FEs/s" << std::endl;
+    }
+}
+
+//Every case runs with the selected variant: kernels and the null objective
+//time it, and the baseline's quality runs use it on each function
+struct BenchVisitor {
+    const BenchOptions* opt;
+    BenchRecords* records;
+
+    template<class Swarm>
+    void operator()(VariantTag<Swarm>) {
+        if(!opt->null_only) benchKernels<Swarm>(*opt, *records);
+        benchNullObjective<Swarm>(*opt, *records);
+        if(opt->null_only) return;
+        benchBasicFunctions<Swarm>(*opt, *records);
+#ifdef USE_CEC2013
+        benchCECSuite<Swarm, CEC2013Benchmark>("cec13", "cec2013", 28, *opt, *records);
+#endif
+#ifdef USE_CEC2017
+        benchCECSuite<Swarm, CEC2017Benchmark>("cec17", "cec2017", 30, *opt, *records);
+#endif
+    }
+};
+
+//Timings and quality statistics as baseline entries
+PerfBaseline makeBaseline(const BenchOptions& opt, const BenchRecords& records) {
+    PerfBaseline baseline;
+    baseline.variant = opt.variant;
+    for(const BenchResult& r : records.timings) {
+        baseline.add(summarize(r.group, r.name, r.dim, r.group == "null" ? "ns_per_fe" : "ns_per_call", r.samples));
+    }
+    for(const BaselineEntry& e : records.quality) baseline.add(e);
+    return baseline;
+}
+
+bool pinToCPU(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+std::vector<int> parseDims(const std::string& text) {
+    std::vector<int> dims;
+    std::stringstream in(text);
+    std::string item;
+    while(std::getline(in, item, ',')) {
+        if(!item.empty()) dims.push_back(atoi(item.c_str()));
+    }
+    return dims;
+}
+
+void printUsage() {
+    std::cout << "\n=== chxpso_bench: ns per call of kernels and benchmark functions ===" << std::endl;
+    std::cout << "\n./chxpso_bench [options]" << std::endl;
+    std::cout << "\nOptions:" << std::endl;
+    std::cout << "  --trials <n>     - Timed trials per case (default 7)" << std::endl;
+    std::cout << "  --min-ms <ms>    - Minimum duration of one trial (default 20)" << std::endl;
+    std::cout << "  --cpu <id>       - CPU to pin to, -1 to not pin (default 0)" << std::endl;
+    std::cout << "  --dims <list>    - Comma-separated dimensions (default 10,30,50,100)" << std::endl;
+    std::cout << "  --filter <text>  - Only cases whose group/name contains text, e.g. cec17/F5" << std::endl;
+    std::cout << "  --variant <name> - Optimizer variant for kernel and null cases:";
+    for(const std::string& name : variantNames()) std::cout << " " << name;
+    std::cout << std::endl;
+    std::cout << "  --null           - Only the null-objective optimizer overhead" << std::endl;
+    std::cout << "\nRegression baselines (timings are only comparable on the same machine):" << std::endl;
+    std::cout << "  --save-baseline <file> - Also run seeded runs per function and write timings and" << std::endl;
+    std::cout << "                           final-error statistics to a baseline JSON" << std::endl;
+    std::cout << "  --compare <file>       - Same measurements, compared against a saved baseline;" << std::endl;
+    std::cout << "                           exit status 2 = speed, 4 = quality regression (or both)" << std::endl;
+    std::cout << "  --runs <n>             - Seeded runs per (function, dim) (default 10)" << std::endl;
+    std::cout << "  --quality-fes <k>      - Budget of those runs, k * dim FEs (default 2000)" << std::endl;
+    std::cout << "  --speed-tol <r>        - Flag slowdowns only when surely above r of the baseline (default 0.05)" << std::endl;
+    std::cout << "  --error-tol <r>        - Same for the mean error (default 0.05)" << std::endl;
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions opt;
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if(arg == "--trials" && i + 1 < argc) {
+            opt.trials = std::max(1, atoi(argv[++i]));
+        } else if(arg == "--min-ms" && i + 1 < argc) {
+            opt.min_ms = atof(argv[++i]);
+        } else if(arg == "--cpu" && i + 1 < argc) {
+            opt.cpu = atoi(argv[++i]);
+        } else if(arg == "--dims" && i + 1 < argc) {
+            opt.dims = parseDims(argv[++i]);
+        } else if(arg == "--filter" && i + 1 < argc) {
+            opt.filter = argv[++i];
+        } else if(arg == "--variant" && i + 1 < argc) {
+            opt.variant = argv[++i];
+        } else if(arg == "--null") {
+            opt.null_only = true;
+        } else if(arg == "--save-baseline" && i + 1 < argc) {
+            opt.save_baseline = argv[++i];
+        } else if(arg == "--compare" && i + 1 < argc) {
+            opt.compare_baseline = argv[++i];
+        } else if(arg == "--runs" && i + 1 < argc) {
+            opt.quality_runs = std::max(1, atoi(argv[++i]));
+        } else if(arg == "--quality-fes" && i + 1 < argc) {
+            opt.quality_fes = std::max(1, atoi(argv[++i]));
+        } else if(arg == "--speed-tol" && i + 1 < argc) {
+            opt.thresholds.speed_tolerance = atof(argv[++i]);
+        } else if(arg == "--error-tol" && i + 1 < argc) {
+            opt.thresholds.error_tolerance = atof(argv[++i]);
+        } else {
+            printUsage();
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    PerfBaseline reference;
+    if(!opt.compare_baseline.empty() && !reference.load(opt.compare_baseline)) {
+        std::cerr << "Cannot read baseline " << opt.compare_baseline << std::endl;
+        return 1;
+    }
+
+    if(opt.cpu >= 0 && !pinToCPU(opt.cpu)) {
+        std::cout << "Warning: cannot pin to CPU " << opt.cpu << ", running unpinned" << std::endl;
+    }
+    std::cout << "Variant: " << opt.variant << ", trials: " << opt.trials << ", min trial: "
+              << opt.min_ms << " ms, CPU: " << opt.cpu << std::endl;
+    printHeader();
+
+    BenchRecords records;
+    BenchVisitor visitor = {&opt, &records};
+    if(!visitVariant(opt.variant, visitor)) {
+        std::cout << "\n Unknown variant: " << opt.variant << std::endl;
+        return 1;
+    }
+    if(!opt.baselineMode()) return 0;
+
+    PerfBaseline current = makeBaseline(opt, records);
+    if(!opt.save_baseline.empty()) {
+        if(!current.write(opt.save_baseline)) {
+            std::cerr << "Cannot write baseline " << opt.save_baseline << std::endl;
+            return 1;
+        }
+        std::cout << "\n✓ Baseline (" << current.getEntries().size() << " entries) saved to "
+                  << opt.save_baseline << std::endl;
+    }
+
+    if(opt.compare_baseline.empty()) return 0;
+    if(reference.variant != current.variant) {
+        std::cout << "\nWarning: baseline was recorded with variant " << reference.variant << std::endl;
+    }
+    int flags = compareBaselines(reference, current, opt.thresholds, std::cout);
+    std::cout << "\n" << (flags & SPEED_REGRESSION ? "SPEED REGRESSION" : "speed OK") << ", "
+              << (flags & QUALITY_REGRESSION ? "QUALITY REGRESSION" : "quality OK") << std::endl;
+    return flags;
+}
@@ -0,0 +1,476 @@
+//Differential validation of the optimized evaluators against the reference
+//implementations: the dimension-major batch kernels and bounded variants of
+//the basic functions, DSL objectives, and DSL rebuilds of CEC functions
+//against cec17_test_func / test_func. Every case feeds the same points to
+//both sides: adversarial ones first (boundaries and corners, the origin,
+//exact optima from shift_data, points next to them and with some
+//coordinates at the optimum, so z[i] == 0 branches are taken), then uniform
+//random points. Reported per case: max absolute and relative error, the
+//kind of point with the worst error, and the speedup over the reference.
+//Exits with 1 when any case exceeds the tolerance.
+#include "benchmarks.h"
+#include "objective_dsl.h"
+#include "lockstep_runner.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <cmath>
+#include <cstdlib>
+#include <unistd.h>
+
+struct ValidateOptions {
+    long long points = 1000000;         //Per case, adversarial ones included
+    std::vector<int> dims = {10, 30, 50, 100};
+    std::string filter;                 //Substring of "group/name"
+    double rel_tol = 1e-12;             //A point fails when |fast - ref| > abs_tol + rel_tol * |ref|
+    double abs_tol = 1e-12;
+    unsigned int seed = 1;
+};
+
+typedef std::function<double(const std::vector<double>&, double)> BoundedEvaluator;
+
+//One optimized evaluator paired with its reference
+struct ValidationCase {
+    std::string group, name;
+    int dim;
+    double lb, ub;
+    std::vector<std::vector<double>> optima;    //Known optima (adversarial points)
+    BatchObjective reference;                   //Row-major block
+    BatchObjective fast;                        //Block in layout
+    BatchLayout layout;
+    BoundedEvaluator bounded;                   //Instead of fast: checked against its contract
+};
+
+struct ValidationResult {
+    long long points = 0;
+    long long failures = 0;
+    long long aborted = 0;              //Bounded cases: points cut short at their bound
+    double max_abs = 0.0, max_rel = 0.0;
+    const char* worst = "-";            //Kind of point with the largest relative error
+    double reference_ns = 0.0, fast_ns = 0.0;
+};
+
+const int BLOCK = 1024;
+const char* const RANDOM_POINT = "random";
+
+double elapsedNs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+//Scalar function as a row-major block evaluator
+template<class F>
+BatchObjective rowwise(F f, int dim) {
+    return [f, dim](const double* X, int m, double* out) {
+        std::vector<double> x(dim);
+        for(int j = 0; j < m; ++j) {
+            x.assign(X + static_cast<size_t>(j) * dim, X + static_cast<size_t>(j + 1) * dim);
+            out[j] = f(x);
+        }
+    };
+}
+
+//Dimension-major batch kernel (benchmarks.h convention) as a block evaluator
+BatchObjective dimMajor(void (*kernel)(const double*, int, int, double*), int dim) {
+    return [kernel, dim](const double* X, int m, double* out) { kernel(X, dim, m, out); };
+}
+
+//---- Points ----
+
+//Block of points with the kind of each, filled with the adversarial points
+//of a case followed by random ones
+class PointSource {
+    const ValidationCase& c;
+    std::mt19937 gen;
+    std::vector<std::vector<double>> adversarial;
+    std::vector<const char*> kinds;
+    size_t next = 0;
+
+    void add(const std::vector<double>& x, const char* kind) {
+        adversarial.push_back(x);
+        kinds.push_back(kind);
+    }
+
+public:
+    PointSource(const ValidationCase& c_, unsigned int seed) : c(c_), gen(seed) {
+        int n = c.dim;
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::bernoulli_distribution coin(0.5);
+
+        //Boundaries: both faces, alternating corners, random corners, points
+        //on a face in some coordinates only
+        add(std::vector<double>(n, c.lb), "boundary");
+        add(std::vector<double>(n, c.ub), "boundary");
+        std::vector<double> x(n);
+        for(int d = 0; d < n; ++d) x[d] = d % 2 ? c.ub : c.lb;
+        add(x, "boundary");
+        for(int k = 0; k < 64; ++k) {
+            for(int d = 0; d < n; ++d) x[d] = coin(gen) ? c.ub : c.lb;
+            add(x, "corner");
+            for(int d = 0; d < n; ++d) x[d] = coin(gen) ? (coin(gen) ? c.ub : c.lb) : c.lb + unit(gen) * (c.ub - c.lb);
+            add(x, "boundary");
+        }
+
+        //Zeros: the origin and points with some coordinates exactly 0
+        add(std::vector<double>(n, 0.0), "zero");
+        for(int k = 0; k < 64; ++k) {
+            for(int d = 0; d < n; ++d) x[d] = coin(gen) ? 0.0 : c.lb + unit(gen) * (c.ub - c.lb);
+            add(x, "zero");
+        }
+
+        //Optima: exact, one ulp away, and with some coordinates at the optimum
+        //(z[i] == 0 in those, before any rotation)
+        for(const std::vector<double>& o : c.optima) {
+            add(o, "optimum");
+            for(int d = 0; d < n; ++d) x[d] = std::nextafter(o[d], c.ub);
+            add(x, "near optimum");
+            for(int d = 0; d < n; ++d) x[d] = std::nextafter(o[d], c.lb);
+            add(x, "near optimum");
+            for(int k = 0; k < 64; ++k) {
+                for(int d = 0; d < n; ++d) x[d] = coin(gen) ? o[d] : c.lb + unit(gen) * (c.ub - c.lb);
+                add(x, "partial optimum");
+                for(int d = 0; d < n; ++d) x[d] = o[d] + (unit(gen) - 0.5) * 1e-6 * (c.ub - c.lb);
+                add(x, "near optimum");
+            }
+        }
+    }
+
+    //Up to m rows into X (row-major); returns the number written
+    int fill(double* X, const char** kind, int m, long long remaining) {
+        std::uniform_real_distribution<double> dis(c.lb, c.ub);
+        int rows = static_cast<int>(std::min<long long>(m, remaining));
+        for(int j = 0; j < rows; ++j) {
+            double* x = X + static_cast<size_t>(j) * c.dim;
+            if(next < adversarial.size()) {
+                std::copy(adversarial[next].begin(), adversarial[next].end(), x);
+                kind[j] = kinds[next++];
+            } else {
+                for(int d = 0; d < c.dim; ++d) x[d] = dis(gen);
+                kind[j] = RANDOM_POINT;
+            }
+        }
+        return rows;
+    }
+};
+
+//---- Comparison ----
+
+void record(ValidationResult& r, double ref, double fast, const char* kind, const ValidateOptions& opt) {
+    double abs_err, rel_err;
+    if(std::isnan(ref) || std::isnan(fast)) {
+        abs_err = rel_err = std::isnan(ref) && std::isnan(fast) ? 0.0 : std::numeric_limits<double>::infinity();
+    } else if(ref == fast) {
+        abs_err = rel_err = 0.0;    //Also equal infinities
+    } else {
+        abs_err = std::fabs(fast - ref);
+        rel_err = ref != 0.0 ? abs_err / std::fabs(ref) : std::numeric_limits<double>::infinity();
+    }
+    if(abs_err > opt.abs_tol + opt.rel_tol * std::fabs(ref)) r.failures++;
+    r.max_abs = std::max(r.max_abs, abs_err);
+    if(rel_err > r.max_rel || (r.worst[0] == '-' && abs_err > 0.0)) {
+        r.max_rel = std::max(r.max_rel, rel_err);
+        r.worst = kind;
+    }
+}
+
+ValidationResult validate(const ValidationCase& c, const ValidateOptions& opt) {
+    ValidationResult r;
+    PointSource source(c, opt.seed);
+    std::vector<double> X(static_cast<size_t>(BLOCK) * c.dim), T(X.size());
+    std::vector<double> ref(BLOCK), fast(BLOCK), bounds(BLOCK);
+    std::vector<const char*> kind(BLOCK);
+    std::vector<double> x(c.dim);
+
+    while(r.points < opt.points) {
+        int m = source.fill(X.data(), kind.data(), BLOCK, opt.points - r.points);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        c.reference(X.data(), m, ref.data());
+        r.reference_ns += elapsedNs(start);
+
+        if(c.bounded) {
+            //Bound of each point: +inf for adversarial points (must be exact),
+            //else the previous point's value, so about half are cut short
+            for(int j = 0; j < m; ++j) {
+                bounds[j] = kind[j] == RANDOM_POINT && j > 0 ? ref[j - 1] : std::numeric_limits<double>::infinity();
+            }
+            start = std::chrono::steady_clock::now();
+            for(int j = 0; j < m; ++j) {
+                x.assign(X.begin() + static_cast<size_t>(j) * c.dim, X.begin() + static_cast<size_t>(j + 1) * c.dim);
+                fast[j] = c.bounded(x, bounds[j]);
+            }
+            r.fast_ns += elapsedNs(start);
+
+            //Below the bound the value must be exact; at or above it, the
+            //true value must be too
+            for(int j = 0; j < m; ++j) {
+                if(fast[j] >= bounds[j]) {
+                    r.aborted++;
+                    if(ref[j] < bounds[j] - (opt.abs_tol + opt.rel_tol * std::fabs(bounds[j]))) {
+                        r.failures++;
+                        r.worst = kind[j];
+                    }
+                } else {
+                    record(r, ref[j], fast[j], kind[j], opt);
+                }
+            }
+        } else {
+            const double* block = X.data();
+            if(c.layout == DIM_MAJOR) {     //Transposed outside the timing, as the lockstep runner fills it
+                for(int j = 0; j < m; ++j) {
+                    for(int d = 0; d < c.dim; ++d) T[static_cast<size_t>(d) * m + j] = X[static_cast<size_t>(j) * c.dim + d];
+                }
+                block = T.data();
+            }
+            start = std::chrono::steady_clock::now();
+            c.fast(block, m, fast.data());
+            r.fast_ns += elapsedNs(start);
+            for(int j = 0; j < m; ++j) record(r, ref[j], fast[j], kind[j], opt);
+        }
+        r.points += m;
+    }
+    return r;
+}
+
+//---- Cases ----
+
+bool selected(const ValidateOptions& opt, const std::string& group, const std::string& name) {
+    return opt.filter.empty() || (group + "/" + name).find(opt.filter) != std::string::npos;
+}
+
+//Cases of the basic functions: batch kernels, bounded variants and DSL
+//objectives against the scalar functions of benchmarks.h
+void basicCases(int dim, std::vector<ValidationCase>& cases) {
+    using namespace dsl;
+    typedef double (*Scalar)(const std::vector<double>&);
+    struct Basic {
+        const char* name;
+        Scalar f;
+        double bound;
+        std::vector<double> optimum;
+        void (*batch)(const double*, int, int, double*);
+        double (*bounded)(const std::vector<double>&, double);
+    };
+    const Basic functions[] = {
+        {"sphere", sphere, 100.0, std::vector<double>(dim, 0.0), sphere_batch, sphere_bounded},
+        {"rastrigin", rastrigin, 5.12, std::vector<double>(dim, 0.0), rastrigin_batch, rastrigin_bounded},
+        {"rosenbrock", rosenbrock, 30.0, std::vector<double>(dim, 1.0), rosenbrock_batch, rosenbrock_bounded},
+        {"ackley", ackley, 32.0, std::vector<double>(dim, 0.0), ackley_batch, nullptr}
+    };
+
+    for(const Basic& b : functions) {
+        ValidationCase c = {"basic", std::string(b.name) + " batch", dim, -b.bound, b.bound, {b.optimum},
+                            rowwise(b.f, dim), dimMajor(b.batch, dim), DIM_MAJOR, nullptr};
+        cases.push_back(c);
+        if(b.bounded) {
+            c.name = std::string(b.name) + " bounded";
+            c.fast = nullptr;
+            c.bounded = b.bounded;
+            cases.push_back(c);
+        }
+    }
+
+    auto dsl_sphere = compile(sum(sq(x)));
+    auto dsl_rastrigin = compile(sum(x * x - 10 * cos(2 * pi * x)) + 10 * D);
+    auto dsl_rosenbrock = compile(sum(100 * sq(x_next - sq(x)) + sq(x - 1)));
+    auto dsl_ackley = compile(-20 * exp(-0.2 * sqrt(sum(sq(x)) / D)) - exp(sum(cos(2 * pi * x)) / D)
+                              + 20 + std::exp(1.0));
+
+    cases.push_back({"dsl", "sphere", dim, -100.0, 100.0, {functions[0].optimum},
+                     rowwise(sphere, dim), rowwise(dsl_sphere, dim), ROW_MAJOR, nullptr});
+    cases.push_back({"dsl", "rastrigin", dim, -5.12, 5.12, {functions[1].optimum},
+                     rowwise(rastrigin, dim), rowwise(dsl_rastrigin, dim), ROW_MAJOR, nullptr});
+    cases.push_back({"dsl", "rastrigin bounded", dim, -5.12, 5.12, {functions[1].optimum},
+                     rowwise(rastrigin, dim), nullptr, ROW_MAJOR,
+                     [dsl_rastrigin](const std::vector<double>& v, double bound) { return dsl_rastrigin.bounded(v, bound); }});
+    cases.push_back({"dsl", "rosenbrock", dim, -30.0, 30.0, {functions[2].optimum},
+                     rowwise(rosenbrock, dim), rowwise(dsl_rosenbrock, dim), ROW_MAJOR, nullptr});
+    cases.push_back({"dsl", "ackley", dim, -32.0, 32.0, {functions[3].optimum},
+                     rowwise(ackley, dim), rowwise(dsl_ackley, dim), ROW_MAJOR, nullptr});
+}
+
+//First count numbers of an input_data file (as the reference reads it: in
+//sequence, across lines); empty if the file is short or missing
+std::vector<double> readNumbers(const std::string& path, size_t count) {
+    std::ifstream in(path);
+    std::vector<double> values;
+    double v;
+    while(values.size() < count && in >> v) values.push_back(v);
+    if(values.size() < count) values.clear();
+    return values;
+}
+
+#ifdef USE_CEC2013
+//CEC 2013 functions rebuilt with the DSL; runs inside cec2013/
+void cec13Cases(int dim, std::vector<ValidationCase>& cases) {
+    using namespace dsl;
+    std::vector<double> o = readNumbers("input_data/shift_data.txt", dim);
+    if(o.empty() || !CEC2013Benchmark::isDefined(1, dim)) return;
+
+    CEC2013Benchmark f1(1, dim);
+    cases.push_back({"cec13", "F1 dsl", dim, -100.0, 100.0, {o},
+                     [f1](const double* X, int m, double* f) mutable { f1.evaluateBatch(X, m, f); },
+                     rowwise(compile(sum(sq(x)) - 1400.0).shifted(o), dim), ROW_MAJOR, nullptr});
+}
+#endif
+
+#ifdef USE_CEC2017
+//CEC 2017 functions rebuilt with the DSL (z = M(x - o) scaled as sr_func);
+//runs inside cec2017/
+void cec17Cases(int dim, std::vector<ValidationCase>& cases) {
+    using namespace dsl;
+    for(int func : {3, 4, 5}) {
+        if(!CEC2017Benchmark::isDefined(func, dim)) continue;
+        std::string id = std::to_string(func);
+        std::vector<double> o = readNumbers("input_data/shift_data_" + id + ".txt", dim);
+        std::vector<double> M = readNumbers("input_data/M_" + id + "_D" + std::to_string(dim) + ".txt",
+                                            static_cast<size_t>(dim) * dim);
+        if(o.empty() || M.empty()) continue;
+
+        CEC2017Benchmark reference(func, dim);
+        BatchObjective fast;
+        if(func == 3) {             //Zakharov
+            fast = rowwise(compile(sum(sq(x)) + sq(sum(0.5 * (i + 1) * x)) + sq(sq(sum(0.5 * (i + 1) * x))) + 300.0)
+                           .shifted(o).rotated(M), dim);
+        } else if(func == 4) {      //Rosenbrock, z + 1
+            fast = rowwise(compile(sum(100 * sq(sq(x + 1) - (x_next + 1)) + sq((x + 1) - 1)) + 400.0)
+                           .shifted(o).scaled(2.048 / 100.0).rotated(M), dim);
+        } else {                    //Rastrigin
+            fast = rowwise(compile(sum(x * x - 10 * cos(2 * pi * x) + 10) + 500.0)
+                           .shifted(o).scaled(5.12 / 100.0).rotated(M), dim);
+        }
+        cases.push_back({"cec17", "F" + id + " dsl", dim, -100.0, 100.0, {o},
+                         [reference](const double* X, int m, double* f) mutable { reference.evaluateBatch(X, m, f); },
+                         fast, ROW_MAJOR, nullptr});
+    }
+}
+#endif
+
+//---- Report ----
+
+void printHeader() {
+    std::cout << std::left << std::setw(8) << "group" << std::setw(20) << "case" << std::right << std::setw(5) << "dim"
+              << std::setw(10) << "points" << std::setw(13) << "max abs" << std::setw(13) << "max rel"
+              << std::setw(17) << "worst at" << std::setw(10) << "ref ns" << std::setw(10) << "fast ns"
+              << std::setw(9) << "speedup" << "  verdict" << std::endl;
+}
+
+void printResult(const ValidationCase& c, const ValidationResult& r) {
+    std::cout << std::left << std::setw(8) << c.group << std::setw(20) << c.name << std::right << std::setw(5) << c.dim
+              << std::setw(10) << r.points << std::scientific << std::setprecision(3)
+              << std::setw(13) << r.max_abs << std::setw(13) << r.max_rel << std::setw(17) << r.worst
+              << std::fixed << std::setprecision(1) << std::setw(10) << r.reference_ns / r.points
+              << std::setw(10) << r.fast_ns / r.points << std::setw(8) << std::setprecision(2)
+              << r.reference_ns / r.fast_ns << "x  " << (r.failures ? "FAIL" : "ok");
+    if(r.failures) std::cout << " (" << r.failures << " points)";
+    if(c.bounded) std::cout << " [" << r.aborted << " cut at bound]";
+    std::cout << std::endl;
+}
+
+//Validates the selected cases; returns the number that failed
+int runCases(const std::vector<ValidationCase>& cases, const ValidateOptions& opt) {
+    int failed = 0;
+    for(const ValidationCase& c : cases) {
+        if(!selected(opt, c.group, c.name)) continue;
+        ValidationResult r = validate(c, opt);
+        printResult(c, r);
+        if(r.failures) failed++;
+    }
+    return failed;
+}
+
+std::vector<int> parseDims(const std::string& text) {
+    std::vector<int> dims;
+    std::stringstream in(text);
+    std::string item;
+    while(std::getline(in, item, ',')) {
+        if(!item.empty()) dims.push_back(atoi(item.c_str()));
+    }
+    return dims;
+}
+
+void printUsage() {
+    std::cout << "\n=== chxpso_validate: optimized evaluators vs reference implementations ===" << std::endl;
+    std::cout << "\n./chxpso_validate [options]" << std::endl;
+    std::cout << "\nOptions:" << std::endl;
+    std::cout << "  --points <n>     - Points per case, adversarial ones first (default 1000000)" << std::endl;
+    std::cout << "  --dims <list>    - Comma-separated dimensions (default 10,30,50,100)" << std::endl;
+    std::cout << "  --filter <text>  - Only cases whose group/name contains text, e.g. cec17/F5" << std::endl;
+    std::cout << "  --rel-tol <r>    - Relative tolerance per point (default 1e-12)" << std::endl;
+    std::cout << "  --abs-tol <a>    - Absolute tolerance per point (default 1e-12)" << std::endl;
+    std::cout << "  --seed <s>       - Seed of the random points (default 1)" << std::endl;
+    std::cout << "\nExit status 1 if any case has a point beyond abs-tol + rel-tol * |reference|." << std::endl;
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    ValidateOptions opt;
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if(arg == "--points" && i + 1 < argc) {
+            opt.points = std::max(1LL, atoll(argv[++i]));
+        } else if(arg == "--dims" && i + 1 < argc) {
+            opt.dims = parseDims(argv[++i]);
+        } else if(arg == "--filter" && i + 1 < argc) {
+            opt.filter = argv[++i];
+        } else if(arg == "--rel-tol" && i + 1 < argc) {
+            opt.rel_tol = atof(argv[++i]);
+        } else if(arg == "--abs-tol" && i + 1 < argc) {
+            opt.abs_tol = atof(argv[++i]);
+        } else if(arg == "--seed" && i + 1 < argc) {
+            opt.seed = static_cast<unsigned int>(atoi(argv[++i]));
+        } else {
+            printUsage();
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    std::cout << "Points per case: " << opt.points << ", tolerance: " << opt.abs_tol << " + "
+              << opt.rel_tol << " * |reference|" << std::endl;
+    printHeader();
+
+    int failed = 0;
+    for(int dim : opt.dims) {
+        std::vector<ValidationCase> cases;
+        basicCases(dim, cases);
+        failed += runCases(cases, opt);
+    }
+
+    //The CEC references read input_data relative to the working directory
+    char original_dir[1024];
+    if(!getcwd(original_dir, sizeof(original_dir))) original_dir[0] = '\0';
+#ifdef USE_CEC2013
+    if(chdir("cec2013") == 0) {
+        for(int dim : opt.dims) {
+            std::vector<ValidationCase> cases;
+            cec13Cases(dim, cases);
+            failed += runCases(cases, opt);
+        }
+        if(chdir(original_dir) != 0) std::cout << "  (cannot return to " << original_dir << ")" << std::endl;
+    } else {
+        std::cout << "  (cec2013/ not found, skipping cec13)" << std::endl;
+    }
+#endif
+#ifdef USE_CEC2017
+    if(chdir("cec2017") == 0) {
+        for(int dim : opt.dims) {
+            std::vector<ValidationCase> cases;
+            cec17Cases(dim, cases);
+            failed += runCases(cases, opt);
+        }
+        if(chdir(original_dir) != 0) std::cout << "  (cannot return to " << original_dir << ")" << std::endl;
+    } else {
+        std::cout << "  (cec2017/ not found, skipping cec17)" << std::endl;
+    }
+#endif
+
+    std::cout << "\n" << (failed ? std::to_string(failed) + " case(s) FAILED" : "All cases within tolerance") << std::endl;
+    return failed ? 1 : 0;
+}
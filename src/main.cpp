@@ -1,6 +1,13 @@
-#include "chppso_abs.h"
-#include "chclpso_abs.h"
+#include "variant_factory.h"
 #include "benchmarks.h"
+#include "shm_islands.h"
+#include "lockstep_runner.h"
+#include "swarm_pool.h"
+#include "observer.h"
+#include "profiler.h"
+#include "trace.h"
+#include "convergence.h"
+#include "results_store.h"
 #include <iostream>
 #include <iomanip>
 #include <vector>
@@ -8,6 +15,11 @@
 #include <fstream>
 #include <unistd.h>
 #include <sstream>
+#include <string>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <chrono>
 
 //Simple statistics calculation
 void calculateStats(const std::vector<double>& results, double& mean, double& std_dev, double& best, double& worst) {
@@ -29,34 +41,185 @@ void calculateStats(const std::vector<double>& results, double& mean, double& st
     std_dev = std::sqrt(std_dev / results.size());
 }
 
+//Run-loop telemetry requested on the command line
+struct TelemetryOptions {
+    bool progress = false;          //--progress: periodic "FEs: ... Best Fit: ..." lines
+    std::ofstream events;           //--telemetry <file>: JSON-lines event log
+    bool convergence = false;       //--convergence: per-run error at the CEC 2017 FE ratios
+};
+static TelemetryOptions telemetry;
+
+//Observers for the runs of one cell; make() returns nullptr when no telemetry is requested
+class RunObservers {
+    std::vector<std::unique_ptr<SwarmObserver>> owned;
+
+public:
+    SwarmObserver* make(const std::string& label, int progress_interval) {
+        if(!telemetry.progress && !telemetry.events.is_open()) return nullptr;
+
+        ObserverFanout* fanout = new ObserverFanout();
+        owned.emplace_back(fanout);
+        if(telemetry.progress) {
+            owned.emplace_back(new ProgressObserver(std::cout, progress_interval, label));
+            fanout->add(owned.back().get());
+        }
+        if(telemetry.events.is_open()) {
+            owned.emplace_back(new JsonLinesObserver(telemetry.events, label));
+            fanout->add(owned.back().get());
+        }
+        return fanout;
+    }
+};
+
+//Phase profiling requested on the command line
+struct ProfileOptions {
+    bool enabled = false;           //--profile: phase report per (function, dim)
+    bool hardware = false;          //--profile-hw: also cycles, instructions and LLC misses
+};
+static ProfileOptions profiling;
+
+//Run seeds, all drawn from one master seed (random_device once, or --seed <s>),
+//so a whole invocation can be repeated from the master seed it prints
+struct RunSeeds {
+    unsigned int master = 0;
+    std::mt19937 gen;
+
+    void init(unsigned int s) {
+        master = s;
+        gen.seed(s);
+    }
+    unsigned int next() { return static_cast<unsigned int>(gen()); }
+};
+static RunSeeds run_seeds;
+
+//Timeline requested with --trace <file>, written when the modes are done
+static std::ofstream trace_file;
+
+//Raw results of every run, streamed to the file given with --store
+static std::unique_ptr<ResultsWriter> run_store;
+
+//Complete the --trace and --store files
+void finishOutputs() {
+    if(run_store) run_store->close();
+    if(!trace_file.is_open()) return;
+    TraceLog::write(trace_file);
+    trace_file.close();
+}
+
+//Objectives without CEC stages to break evaluation time into
+struct NoEvaluationStages {
+    static void enableStageTiming(bool) {}
+    static void takeStageTimes(double& shift_rotate_ns, double& cf_cal_ns) {
+        shift_rotate_ns = cf_cal_ns = 0.0;
+    }
+};
+
+//Profile report of one suite; not opened unless profiling
+void openProfileReport(std::ofstream& out, const std::string& path, const std::string& title) {
+    if(!profiling.enabled) return;
+    out.open(path);
+    out << "Phase profile - " << title << '\n';
+    out << "Evaluate calls are batched objective calls (one per lockstep step) in the CEC suites" << '\n';
+}
+
+//Started profiler of one (function, dim) cell with Benchmark's stage timing
+//on, or nullptr when profiling is off
+template<class Benchmark>
+std::unique_ptr<PhaseProfiler> startCellProfile() {
+    std::unique_ptr<PhaseProfiler> profiler;
+    if(!profiling.enabled) return profiler;
+    profiler.reset(new PhaseProfiler(profiling.hardware));
+    if(profiling.hardware && !profiler->hasHardwareCounters()) {
+        std::cout << "  (hardware counters unavailable, timing only)" << std::endl;
+    }
+    Benchmark::enableStageTiming(true);
+    profiler->start();
+    return profiler;
+}
+
+template<class Benchmark>
+void finishCellProfile(PhaseProfiler* profiler, std::ostream& out, const std::string& label) {
+    if(!profiler) return;
+    profiler->stop();
+    double shift_rotate_ns, cf_cal_ns;
+    Benchmark::takeStageTimes(shift_rotate_ns, cf_cal_ns);
+    Benchmark::enableStageTiming(false);
+    profiler->addEvaluationStages(shift_rotate_ns, cf_cal_ns);
+    out << '\n';
+    profiler->report(out, label);
+    out.flush();
+}
+
+//Convergence curves of one suite; not opened unless requested
+void openConvergenceReport(std::ofstream& out, const std::string& path, const std::string& title) {
+    if(!telemetry.convergence) return;
+    out.open(path);
+    out << "Convergence - " << title << " (best error at FE milestones, one column per run)" << '\n';
+}
+
+//Recorders for the runs of one cell at the CEC 2017 ratios, or nullptr when not requested
+std::unique_ptr<ConvergenceTable> makeConvergenceTable(int max_FEs, int num_runs, double optimum) {
+    std::unique_ptr<ConvergenceTable> table;
+    if(telemetry.convergence) {
+        table.reset(new ConvergenceTable(ConvergenceTable::cec2017Ratios(), max_FEs, num_runs, optimum));
+    }
+    return table;
+}
+
+template<class Swarm>
+void storeRun(const std::string& suite, int func, const std::string& func_name, int dim, int run, unsigned int seed,
+              Swarm& swarm, double optimum, double seconds, const ConvergenceTable* convergence) {
+    if(!run_store) return;
+    RunRecord record = {suite, Swarm::variantName(), func, func_name, dim, run, seed, swarm.getGBestFitness() - optimum, optimum,
+                        swarm.getEvaluationStats().FEs, seconds,
+                        convergence ? convergence->curve(run - 1) : nullptr};
+    run_store->append(record);
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
 //Basic Benchmark - All Dimensions
+template<class Swarm>
 void runBasicTests(const std::vector<int>& dimensions, int N, int M, int num_runs) {
     std::cout << "\n=== Running Basic Benchmark Tests for All Dimensions ===" << std::endl;
 
     struct TestFunction {
         std::string name;
         std::function<double(const std::vector<double>&)> func;
+        std::function<double(const std::vector<double>&, double)> bounded;  //Early-abort variant (optional)
         double lb, ub;
     };
 
     std::vector<TestFunction> test_functions = {
-        {"Sphere", sphere, -100.0, 100.0},
-        {"Rastrigin", rastrigin, -5.12, 5.12},
-        {"Rosenbrock", rosenbrock, -30.0, 30.0},
-        {"Ackley", ackley, -32.0, 32.0}
+        {"Sphere", sphere, sphere_bounded, -100.0, 100.0},
+        {"Rastrigin", rastrigin, rastrigin_bounded, -5.12, 5.12},
+        {"Rosenbrock", rosenbrock, rosenbrock_bounded, -30.0, 30.0},
+        {"Ackley", ackley, nullptr, -32.0, 32.0}
     };
 
+    //Instances are reused across runs and functions
+    SwarmPool<Swarm> pool;
+
+    std::ofstream profile_out;
+    openProfileReport(profile_out, "results_profile_basic.txt", std::string("Basic - ") + Swarm::variantName());
+
+    std::ofstream convergence_out;
+    openConvergenceReport(convergence_out, "results_convergence_basic.txt", std::string("Basic - ") + Swarm::variantName());
+
     std::ofstream outfile("results_basic_all_dimensions.txt");
     outfile << std::fixed << std::setprecision(6);
     outfile << "=====================================================" << std::endl;
-    outfile << "Basic Benchmark Results - CHCLPSO-ABS (All Raw Values)" << std::endl;
+    outfile << "Basic Benchmark Results - " << Swarm::variantName() << " (All Raw Values)" << std::endl;
     outfile << "All Dimensions: ";
     for(int d : dimensions) outfile << d << "D ";
     outfile << std::endl;
     outfile << "Runs per test: " << num_runs << std::endl;
     outfile << "=====================================================" << std::endl;
 
-    for(const auto& test : test_functions) {
+    for(size_t t = 0; t < test_functions.size(); t++) {
+        const TestFunction& test = test_functions[t];
         outfile << "\n\n========== Function: " << test.name << " ==========" << std::endl;
         
         //Header row with Run numbers
@@ -73,19 +236,33 @@ void runBasicTests(const std::vector<int>& dimensions, int N, int M, int num_run
             int max_FEs = 10000 * dim;
             std::vector<double> results;
 
+            RunObservers observers;
+            TraceSpan cell("cell", "runner", test.name + "/" + std::to_string(dim) + "D");
+            std::unique_ptr<PhaseProfiler> profiler = startCellProfile<NoEvaluationStages>();
+            std::unique_ptr<ConvergenceTable> convergence = makeConvergenceTable(max_FEs, num_runs, 0.0);
             for(int run = 0; run < num_runs; run++) {
-                CHCLPSO_ABS alg(N, dim, max_FEs, M);
+                unsigned int seed = run_seeds.next();
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                Swarm& alg = pool.acquire(N, dim, max_FEs, M, seed);
+                alg.setObserver(observers.make(test.name + "/" + std::to_string(dim) + "D/" + std::to_string(run + 1), 100 * N));
+                alg.setProfiler(profiler.get());
+                if(convergence) alg.setConvergenceRecorder(&convergence->recorder(run));
                 alg.setObjective(test.func);
+                if(test.bounded) alg.setBoundedObjective(test.bounded);
                 alg.setBounds(test.lb, test.ub);
                 alg.run();
 
                 double fitness = alg.getGBestFitness();
                 results.push_back(fitness);
+                storeRun("basic", static_cast<int>(t) + 1, test.name, dim, run + 1, seed, alg, 0.0, secondsSince(start), convergence.get());
+                pool.release(alg);
 
                 if((run + 1) % 10 == 0 || run == num_runs - 1) {
                     std::cout << "  Completed " << (run + 1) << "/" << num_runs << " runs" << std::endl;
                 }
             }
+            finishCellProfile<NoEvaluationStages>(profiler.get(), profile_out, test.name + "/" + std::to_string(dim) + "D");
+            if(convergence) convergence->write(convergence_out, test.name + "/" + std::to_string(dim) + "D");
 
             double mean, std_dev, best, worst;
             calculateStats(results, mean, std_dev, best, worst);
@@ -108,6 +285,7 @@ void runBasicTests(const std::vector<int>& dimensions, int N, int M, int num_run
 
 //CEC 2013 Benchmark - All Dimensions
 #ifdef USE_CEC2013
+template<class Swarm>
 void runCEC2013Tests(const std::vector<int>& dimensions, int N, int M, int num_runs) {
     std::cout << "\n=== Running CEC 2013 Tests for All Dimensions ===" << std::endl;
     
@@ -116,10 +294,19 @@ void runCEC2013Tests(const std::vector<int>& dimensions, int N, int M, int num_r
     chdir("cec2013");
     std::cout << "Working directory changed to cec2013/" << std::endl;
 
+    //Instances are reused across runs and functions of the same dimension
+    SwarmPool<Swarm> pool;
+
+    std::ofstream profile_out;
+    openProfileReport(profile_out, "../results_profile_cec2013.txt", std::string("CEC 2013 - ") + Swarm::variantName());
+
+    std::ofstream convergence_out;
+    openConvergenceReport(convergence_out, "../results_convergence_cec2013.txt", std::string("CEC 2013 - ") + Swarm::variantName());
+
     std::ofstream outfile("../results_cec2013_all_dimensions.txt");
     outfile << std::fixed << std::setprecision(6);
     outfile << "=====================================================" << std::endl;
-    outfile << "CEC 2013 Results - CHCLPSO-ABS (All Raw Values)" << std::endl;
+    outfile << "CEC 2013 Results - " << Swarm::variantName() << " (All Raw Values)" << std::endl;
     outfile << "All Dimensions: ";
     for(int d : dimensions) outfile << d << "D ";
     outfile << std::endl;
@@ -144,27 +331,46 @@ void runCEC2013Tests(const std::vector<int>& dimensions, int N, int M, int num_r
             std::cout << "  " << dim << "D: ";
             
             int max_FEs = 10000 * dim;
+            TraceSpan cell("cell", "runner", "F" + std::to_string(func) + "/" + std::to_string(dim) + "D");
             CEC2013Benchmark benchmark(func, dim);
             std::vector<double> results;
             
             double lb, ub;
             CEC2013Benchmark::getBounds(func, lb, ub);
             
+            //All runs of the cell advance in lockstep with one batched evaluation per step
+            std::vector<unsigned int> seeds(num_runs);
+            for(unsigned int& seed : seeds) seed = run_seeds.next();
+            
+            LockstepRunner<Swarm> runs(pool, N, dim, max_FEs, M, seeds);
+            runs.setBounds(lb, ub);
+            runs.setBatchObjective([&benchmark](const double* X, int m, double* f) {
+                benchmark.evaluateBatch(X, m, f);
+            });
+            RunObservers observers;
             for(int run = 0; run < num_runs; run++) {
-                CHCLPSO_ABS alg(N, dim, max_FEs, M);
-                alg.setBounds(lb, ub);
-                
-                alg.setObjective([&benchmark](const std::vector<double>& x) {
-                    return benchmark.evaluate(x);
-                });
-                
-                alg.run();
-                results.push_back(alg.getGBestFitness());
-                
-                if((run + 1) % 10 == 0 || run == num_runs - 1) {
-                    std::cout << ".";
-                    std::cout.flush();
-                }
+                std::string label = "F" + std::to_string(func) + "/" + std::to_string(dim) + "D/" + std::to_string(run + 1);
+                runs.getRun(run).setObserver(observers.make(label, 100 * N));
+            }
+            std::unique_ptr<ConvergenceTable> convergence =
+                makeConvergenceTable(max_FEs, num_runs, CEC2013Benchmark::getOptimalValue(func));
+            if(convergence) {
+                for(int run = 0; run < num_runs; run++) runs.getRun(run).setConvergenceRecorder(&convergence->recorder(run));
+            }
+            std::unique_ptr<PhaseProfiler> profiler = startCellProfile<CEC2013Benchmark>();
+            runs.setProfiler(profiler.get());
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            runs.run();
+            double seconds_per_run = secondsSince(start) / num_runs;    //Runs advance interleaved
+            for(int run = 0; run < num_runs; run++) {
+                storeRun("cec2013", func, "", dim, run + 1, seeds[run], runs.getRun(run), CEC2013Benchmark::getOptimalValue(func),
+                         seconds_per_run, convergence.get());
+            }
+            finishCellProfile<CEC2013Benchmark>(profiler.get(), profile_out, "F" + std::to_string(func) + "/" + std::to_string(dim) + "D");
+            if(convergence) convergence->write(convergence_out, "F" + std::to_string(func) + "/" + std::to_string(dim) + "D");
+            
+            for(int run = 0; run < num_runs; run++) {
+                results.push_back(runs.getRun(run).getGBestFitness());
             }
             
             double mean, std_dev, best, worst;
@@ -193,6 +399,7 @@ void runCEC2013Tests(const std::vector<int>& dimensions, int N, int M, int num_r
 
 //CEC 2017 Benchmark - All Dimensions
 #ifdef USE_CEC2017
+template<class Swarm>
 void runCEC2017Tests(const std::vector<int>& dimensions, int N, int M, int num_runs) {
     std::cout << "\n=== Running CEC 2017 Tests for All Dimensions ===" << std::endl;
     
@@ -201,10 +408,19 @@ void runCEC2017Tests(const std::vector<int>& dimensions, int N, int M, int num_r
     chdir("cec2017");
     std::cout << "Working directory changed to cec2017/" << std::endl;
 
+    //Instances are reused across runs and functions of the same dimension
+    SwarmPool<Swarm> pool;
+
+    std::ofstream profile_out;
+    openProfileReport(profile_out, "../results_profile_cec2017.txt", std::string("CEC 2017 - ") + Swarm::variantName());
+
+    std::ofstream convergence_out;
+    openConvergenceReport(convergence_out, "../results_convergence_cec2017.txt", std::string("CEC 2017 - ") + Swarm::variantName());
+
     std::ofstream outfile("../results_cec2017_all_dimensions.txt");
     outfile << std::fixed << std::setprecision(6);
     outfile << "=====================================================" << std::endl;
-    outfile << "CEC 2017 Results - CHCLPSO-ABS (All Raw Values)" << std::endl;
+    outfile << "CEC 2017 Results - " << Swarm::variantName() << " (All Raw Values)" << std::endl;
     outfile << "All Dimensions: ";
     for(int d : dimensions) outfile << d << "D ";
     outfile << std::endl;
@@ -231,27 +447,46 @@ void runCEC2017Tests(const std::vector<int>& dimensions, int N, int M, int num_r
             std::cout << "  " << dim << "D: ";
             
             int max_FEs = 10000 * dim;
+            TraceSpan cell("cell", "runner", "F" + std::to_string(func) + "/" + std::to_string(dim) + "D");
             CEC2017Benchmark benchmark(func, dim);
             std::vector<double> results;
             
             double lb, ub;
             CEC2017Benchmark::getBounds(func, lb, ub);
             
+            //All runs of the cell advance in lockstep with one batched evaluation per step
+            std::vector<unsigned int> seeds(num_runs);
+            for(unsigned int& seed : seeds) seed = run_seeds.next();
+            
+            LockstepRunner<Swarm> runs(pool, N, dim, max_FEs, M, seeds);
+            runs.setBounds(lb, ub);
+            runs.setBatchObjective([&benchmark](const double* X, int m, double* f) {
+                benchmark.evaluateBatch(X, m, f);
+            });
+            RunObservers observers;
             for(int run = 0; run < num_runs; run++) {
-                CHCLPSO_ABS alg(N, dim, max_FEs, M);
-                alg.setBounds(lb, ub);
-                
-                alg.setObjective([&benchmark](const std::vector<double>& x) {
-                    return benchmark.evaluate(x);
-                });
-                
-                alg.run();
-                results.push_back(alg.getGBestFitness());
-                
-                if((run + 1) % 10 == 0 || run == num_runs - 1) {
-                    std::cout << ".";
-                    std::cout.flush();
-                }
+                std::string label = "F" + std::to_string(func) + "/" + std::to_string(dim) + "D/" + std::to_string(run + 1);
+                runs.getRun(run).setObserver(observers.make(label, 100 * N));
+            }
+            std::unique_ptr<ConvergenceTable> convergence =
+                makeConvergenceTable(max_FEs, num_runs, CEC2017Benchmark::getOptimalValue(func));
+            if(convergence) {
+                for(int run = 0; run < num_runs; run++) runs.getRun(run).setConvergenceRecorder(&convergence->recorder(run));
+            }
+            std::unique_ptr<PhaseProfiler> profiler = startCellProfile<CEC2017Benchmark>();
+            runs.setProfiler(profiler.get());
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            runs.run();
+            double seconds_per_run = secondsSince(start) / num_runs;    //Runs advance interleaved
+            for(int run = 0; run < num_runs; run++) {
+                storeRun("cec2017", func, "", dim, run + 1, seeds[run], runs.getRun(run), CEC2017Benchmark::getOptimalValue(func),
+                         seconds_per_run, convergence.get());
+            }
+            finishCellProfile<CEC2017Benchmark>(profiler.get(), profile_out, "F" + std::to_string(func) + "/" + std::to_string(dim) + "D");
+            if(convergence) convergence->write(convergence_out, "F" + std::to_string(func) + "/" + std::to_string(dim) + "D");
+            
+            for(int run = 0; run < num_runs; run++) {
+                results.push_back(runs.getRun(run).getGBestFitness());
             }
             
             double mean, std_dev, best, worst;
@@ -278,6 +513,146 @@ void runCEC2017Tests(const std::vector<int>& dimensions, int N, int M, int num_r
 }
 #endif
 
+//Final errors of one (function, dim) cell, one lockstep run per seed, with swarm state in Real
+template<class Real, class Benchmark>
+std::vector<double> runPrecisionCell(int func, int dim, int N, int M, const std::vector<unsigned int>& seeds) {
+    Benchmark benchmark(func, dim);
+    double lb, ub;
+    Benchmark::getBounds(func, lb, ub);
+    
+    LockstepRunner<CHCLPSO_ABS_T<Real>> runs(static_cast<int>(seeds.size()), N, dim, 10000 * dim, M, seeds);
+    runs.setBounds(lb, ub);
+    runs.setBatchObjective([&benchmark](const double* X, int m, double* f) {
+        benchmark.evaluateBatch(X, m, f);
+    });
+    runs.run();
+    
+    std::vector<double> errors;
+    for(int run = 0; run < runs.size(); run++) {
+        errors.push_back(runs.getRun(run).getGBestFitness() - Benchmark::getOptimalValue(func));
+    }
+    return errors;
+}
+
+//Precision report: final errors with double and float swarm state on the same seeds
+template<class Benchmark>
+void runPrecisionComparison(const std::string& suite, const std::vector<int>& functions,
+                            const std::vector<int>& dimensions, int N, int M, int num_runs) {
+    std::cout << "\n=== Precision comparison (double vs float swarm state): " << suite << " ===" << std::endl;
+    
+    char original_dir[1024];
+    getcwd(original_dir, sizeof(original_dir));
+    chdir(suite.c_str());
+    
+    std::string filename = "results_precision_" + suite + ".txt";
+    std::ofstream outfile(("../" + filename).c_str());
+    outfile << std::scientific << std::setprecision(6);
+    outfile << "=====================================================" << std::endl;
+    outfile << "Precision Comparison - CHCLPSO-ABS, " << suite << std::endl;
+    outfile << "Mean error over " << num_runs << " runs, same seeds for both modes" << std::endl;
+    outfile << "=====================================================" << std::endl;
+    
+    for(int func : functions) {
+        outfile << "\n\n========== F" << func << " ==========" << std::endl;
+        outfile << "Dim\tDouble\t\tFloat\t\tFloat/Double" << std::endl;
+        outfile << "-----------------------------------------------------------------------" << std::endl;
+        std::cout << "\n[F" << func << "]" << std::endl;
+        
+        for(int dim : dimensions) {
+            std::vector<unsigned int> seeds(num_runs);
+            for(unsigned int& seed : seeds) seed = run_seeds.next();
+            
+            double mean_double, mean_float, std_dev, best, worst;
+            calculateStats(runPrecisionCell<double, Benchmark>(func, dim, N, M, seeds), mean_double, std_dev, best, worst);
+            calculateStats(runPrecisionCell<float, Benchmark>(func, dim, N, M, seeds), mean_float, std_dev, best, worst);
+            double ratio = mean_double > 0.0 ? mean_float / mean_double : 1.0;
+            
+            std::cout << "  " << dim << "D: double=" << mean_double << ", float=" << mean_float << std::endl;
+            outfile << dim << "D\t" << mean_double << "\t" << mean_float << "\t" << ratio << std::endl;
+        }
+    }
+    
+    outfile.close();
+    chdir(original_dir);
+    std::cout << "\n✓ Precision comparison saved to " << filename << std::endl;
+}
+
+//Multi-process island run on one function: islands <suite> <func> <dim> [workers]
+template<class Swarm>
+int runIslandProcesses(int argc, char* argv[], int N, int M) {
+    if(argc < 5) {
+        std::cout << "\n Usage: ./chxpso islands <basic|cec13|cec17> <func> <dim> [workers]" << std::endl;
+        return 1;
+    }
+    std::string suite = argv[2];
+    int func = atoi(argv[3]);
+    int dim = atoi(argv[4]);
+    int workers = (argc > 5) ? atoi(argv[5]) : static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+    if(workers < 1) workers = 1;
+    int max_FEs = 10000 * dim;
+
+    typedef std::function<double(const std::vector<double>&)> Objective;
+    std::function<Objective(int)> factory;
+    double lb = -100.0, ub = 100.0, optimal = 0.0;
+
+    if(suite == "basic") {
+        std::vector<Objective> funcs = {sphere, rastrigin, rosenbrock, ackley};
+        const double bounds[4] = {100.0, 5.12, 30.0, 32.0};
+        if(func < 1 || func > 4) {
+            std::cout << "\n Basic functions are 1-4 (Sphere, Rastrigin, Rosenbrock, Ackley)" << std::endl;
+            return 1;
+        }
+        Objective f = funcs[func - 1];
+        factory = [f](int) { return f; };
+        lb = -bounds[func - 1];
+        ub = bounds[func - 1];
+    }
+#ifdef USE_CEC2013
+    else if(suite == "cec13" || suite == "cec2013") {
+        if(chdir("cec2013") != 0) return 1;
+        factory = [func, dim](int) {
+            std::shared_ptr<CEC2013Benchmark> bench(new CEC2013Benchmark(func, dim));
+            return Objective([bench](const std::vector<double>& x) { return bench->evaluate(x); });
+        };
+        CEC2013Benchmark::getBounds(func, lb, ub);
+        optimal = CEC2013Benchmark::getOptimalValue(func);
+    }
+#endif
+#ifdef USE_CEC2017
+    else if(suite == "cec17" || suite == "cec2017") {
+        if(chdir("cec2017") != 0) return 1;
+        factory = [func, dim](int) {
+            std::shared_ptr<CEC2017Benchmark> bench(new CEC2017Benchmark(func, dim));
+            return Objective([bench](const std::vector<double>& x) { return bench->evaluate(x); });
+        };
+        CEC2017Benchmark::getBounds(func, lb, ub);
+        optimal = CEC2017Benchmark::getOptimalValue(func);
+    }
+#endif
+    else {
+        std::cout << "\n Unknown or unavailable suite: " << suite << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Multi-process islands: " << suite << " F" << func << " " << dim << "D, "
+              << workers << " workers ===" << std::endl;
+
+    ProcessIslandModel<Swarm> model(workers, N, dim, max_FEs, M, RING, 50 * N);
+    model.setObjectiveFactory(factory);
+    model.setBounds(lb, ub);
+    bool ok = model.run();
+
+    for(int i : model.getCrashedWorkers()) {
+        std::cout << "  Worker " << i << " did not finish (crashed or killed)" << std::endl;
+    }
+    if(!ok) {
+        std::cout << "  No result available" << std::endl;
+        return 1;
+    }
+    std::cout << "  Best=" << model.getGBestFitness() << ", Error=" << model.getGBestFitness() - optimal << std::endl;
+    return 0;
+}
+
 //Usage
 void printUsage() {
     std::cout << "\n=== CHxPSO-ABS Usage ===" << std::endl;
@@ -285,11 +660,94 @@ void printUsage() {
     std::cout << "./chxpso cec13     - Run CEC 2013 benchmark (all dimensions)" << std::endl;
     std::cout << "./chxpso cec17     - Run CEC 2017 benchmark (all dimensions)" << std::endl;
     std::cout << "./chxpso all       - Run all available benchmarks (all dimensions)" << std::endl;
+    std::cout << "./chxpso islands <suite> <func> <dim> [workers]" << std::endl;
+    std::cout << "                   - Run one function with multi-process islands" << std::endl;
+    std::cout << "./chxpso totext <file.chxr>" << std::endl;
+    std::cout << "                   - Print a --store results file as text tables" << std::endl;
+    std::cout << "./chxpso precision [cec13|cec17]" << std::endl;
+    std::cout << "                   - Compare final errors of double and float swarm state" << std::endl;
+    std::cout << "\nOptions:" << std::endl;
+    std::cout << "  --variant <name> - Optimizer variant:";
+    for(const std::string& name : variantNames()) std::cout << " " << name;
+    std::cout << " (default: chclpso)" << std::endl;
+    std::cout << "  --seed <s>       - Master seed all run seeds are drawn from (default: random)" << std::endl;
+    std::cout << "  --progress       - Print each run's best fitness every 100*N FEs" << std::endl;
+    std::cout << "  --telemetry <file> - Write run events (improvements, reconstructions," << std::endl;
+    std::cout << "                     thresholds, run ends) as JSON lines" << std::endl;
+    std::cout << "  --convergence    - Write each run's best error at the CEC 2017 FE ratios" << std::endl;
+    std::cout << "                     to results_convergence_<suite>.txt" << std::endl;
+    std::cout << "  --store <file>   - Stream every run (seed, error, FEs, time, and curves with" << std::endl;
+    std::cout << "                     --convergence) to a columnar binary file (.chxr)" << std::endl;
+    std::cout << "  --trace <file>   - Write a Chrome/Perfetto timeline of cells, runs and" << std::endl;
+    std::cout << "                     migrations (threads and island processes)" << std::endl;
+    std::cout << "  --trace-evals    - With --trace, also record every objective evaluation" << std::endl;
+    std::cout << "  --profile        - Write a phase time breakdown per function and dimension" << std::endl;
+    std::cout << "                     to results_profile_<suite>.txt" << std::endl;
+    std::cout << "  --profile-hw     - As --profile, adding cycles, instructions and LLC misses" << std::endl;
+    std::cout << "                     (perf_event_open)" << std::endl;
     std::cout << "\nNote: Tests will run on 10D, 30D, 50D, and 100D" << std::endl;
     std::cout << "      Results saved in separate files with all dimensions" << std::endl;
     std::cout << std::endl;
 }
 
+//Run one benchmark mode with the variant Swarm. Returns the exit status, or -1 for an unknown mode.
+template<class Swarm>
+int runMode(const std::string& mode, int argc, char* argv[],
+            const std::vector<int>& dimensions, int N, int M, int num_runs) {
+    if (mode == "islands") {
+        return runIslandProcesses<Swarm>(argc, argv, N, M);
+    }
+    else if (mode == "basic" || argc == 1) {
+        runBasicTests<Swarm>(dimensions, N, M, num_runs);
+    }
+    else if (mode == "cec13" || mode == "cec2013") {
+#ifdef USE_CEC2013
+        runCEC2013Tests<Swarm>(dimensions, N, M, num_runs);
+#else
+        std::cout << "\n CEC 2013 not available!" << std::endl;
+        std::cout << "CEC 2013 files not found during compilation" << std::endl;
+        return 1;
+#endif
+    }
+    else if (mode == "cec17" || mode == "cec2017") {
+#ifdef USE_CEC2017
+        runCEC2017Tests<Swarm>(dimensions, N, M, num_runs);
+#else
+        std::cout << "\n CEC 2017 not available!" << std::endl;
+        std::cout << "CEC 2017 files not found during compilation" << std::endl;
+        return 1;
+#endif
+    }
+    else if (mode == "all") {
+        runBasicTests<Swarm>(dimensions, N, M, num_runs);
+#ifdef USE_CEC2013
+        runCEC2013Tests<Swarm>(dimensions, N, M, num_runs);
+#endif
+#ifdef USE_CEC2017
+        runCEC2017Tests<Swarm>(dimensions, N, M, num_runs);
+#endif
+    }
+    else {
+        return -1;
+    }
+    return 0;
+}
+
+//Dispatches runMode to the variant picked by visitVariant
+struct ModeVisitor {
+    std::string mode;
+    int argc;
+    char** argv;
+    std::vector<int> dimensions;
+    int N, M, num_runs;
+    int status;
+    
+    template<class Swarm>
+    void operator()(VariantTag<Swarm>) {
+        status = runMode<Swarm>(mode, argc, argv, dimensions, N, M, num_runs);
+    }
+};
+
 //Main
 int main(int argc, char* argv[]) {
     //Experimental parameters (following the paper)
@@ -297,16 +755,91 @@ int main(int argc, char* argv[]) {
     int N = 20;                      //Population size (number of layers)
     int M = 6;                       //Total upper threshold
     int num_runs = 3;                //Number of runs
+    
+    //Strip the options so the positional arguments keep their places
+    std::string variant = "chclpso";
+    std::string trace_path;
+    std::string store_path;
+    bool trace_evaluations = false;
+    unsigned int master_seed = std::random_device{}();
+    std::vector<char*> args;
+    for(int i = 0; i < argc; i++) {
+        std::string arg = argv[i];
+        if(arg == "--variant" && i + 1 < argc) {
+            variant = argv[++i];
+        } else if(arg == "--convergence") {
+            telemetry.convergence = true;
+        } else if(arg == "--progress") {
+            telemetry.progress = true;
+        } else if(arg == "--seed" && i + 1 < argc) {
+            master_seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if(arg == "--store" && i + 1 < argc) {
+            store_path = argv[++i];
+        } else if(arg == "--trace" && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if(arg == "--trace-evals") {
+            trace_evaluations = true;
+        } else if(arg == "--profile") {
+            profiling.enabled = true;
+        } else if(arg == "--profile-hw") {
+            profiling.enabled = true;
+            profiling.hardware = true;
+        } else if(arg == "--telemetry" && i + 1 < argc) {
+            telemetry.events.open(argv[++i]);
+            if(!telemetry.events) {
+                std::cout << "\n Cannot open telemetry file: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+    argc = static_cast<int>(args.size());
+    argv = args.data();
+    run_seeds.init(master_seed);
+
+    //Converter from a --store file to the text tables (stdout holds only the tables)
+    if(argc > 1 && std::string(argv[1]) == "totext") {
+        ResultsFile file;
+        if(argc < 3 || !file.open(argv[2])) {
+            std::cerr << "Cannot read results store: " << (argc < 3 ? "(none given)" : argv[2]) << std::endl;
+            return 1;
+        }
+        writeResultsAsText(file, std::cout);
+        return 0;
+    }
+
+    if(!store_path.empty()) {
+        std::vector<double> ratios;
+        if(telemetry.convergence) ratios = ConvergenceTable::cec2017Ratios();
+        run_store.reset(new ResultsWriter(store_path, ratios));
+        if(!run_store->ok()) {
+            std::cout << "\n Cannot open results store: " << store_path << std::endl;
+            return 1;
+        }
+    }
+
+    if(!trace_path.empty()) {
+        trace_file.open(trace_path);
+        if(!trace_file) {
+            std::cout << "\n Cannot open trace file: " << trace_path << std::endl;
+            return 1;
+        }
+        TraceLog::enable(trace_evaluations ? TRACE_EVALUATIONS : TRACE_RUNS, trace_path);
+        TraceLog::nameThread("runner");
+    }
 
     std::cout << std::fixed << std::setprecision(6);
     std::cout << "=====================================================" << std::endl;
     std::cout << "CHxPSO-ABS Implementation - Multi-Dimensional Testing" << std::endl;
+    std::cout << "Variant: " << variant << std::endl;
     std::cout << "Dimensions: ";
     for(int d : dimensions) std::cout << d << "D ";
     std::cout << std::endl;
     std::cout << "Population size (N): " << N << std::endl;
     std::cout << "M: " << M << std::endl;
     std::cout << "Number of runs per test: " << num_runs << std::endl;
+    std::cout << "Master seed: " << master_seed << std::endl;
     std::cout << "=====================================================" << std::endl;
     
     if(num_runs == 51) {
@@ -330,43 +863,52 @@ int main(int argc, char* argv[]) {
         return 0;
     }
     
-    //Run based on mode
-    if (mode == "basic" || argc == 1) {
-        runBasicTests(dimensions, N, M, num_runs);
-    }
-    else if (mode == "cec13" || mode == "cec2013") {
-#ifdef USE_CEC2013
-        runCEC2013Tests(dimensions, N, M, num_runs);
-#else
-        std::cout << "\n CEC 2013 not available!" << std::endl;
-        std::cout << "CEC 2013 files not found during compilation" << std::endl;
-        return 1;
-#endif
-    }
-    else if (mode == "cec17" || mode == "cec2017") {
-#ifdef USE_CEC2017
-        runCEC2017Tests(dimensions, N, M, num_runs);
-#else
-        std::cout << "\n CEC 2017 not available!" << std::endl;
-        std::cout << "CEC 2017 files not found during compilation" << std::endl;
-        return 1;
-#endif
-    }
-    else if (mode == "all") {
-        runBasicTests(dimensions, N, M, num_runs);
+    //Precision comparison always uses CHCLPSO-ABS in both precisions
+    if (mode == "precision") {
+        std::string suite = (argc > 2) ? argv[2] : "all";
+        bool ran = false;
 #ifdef USE_CEC2013
-        runCEC2013Tests(dimensions, N, M, num_runs);
+        if(suite == "all" || suite == "cec13" || suite == "cec2013") {
+            std::vector<int> functions;
+            for(int i = 1; i <= 28; i++) functions.push_back(i);
+            runPrecisionComparison<CEC2013Benchmark>("cec2013", functions, dimensions, N, M, num_runs);
+            ran = true;
+        }
 #endif
 #ifdef USE_CEC2017
-        runCEC2017Tests(dimensions, N, M, num_runs);
+        if(suite == "all" || suite == "cec17" || suite == "cec2017") {
+            std::vector<int> functions = {1};
+            for(int i = 3; i <= 30; i++) functions.push_back(i);
+            runPrecisionComparison<CEC2017Benchmark>("cec2017", functions, dimensions, N, M, num_runs);
+            ran = true;
+        }
 #endif
+        if(!ran) {
+            std::cout << "\n No CEC suite available for: " << suite << std::endl;
+            return 1;
+        }
     }
     else {
-        std::cout << "\n Unknown option: " << argv[1] << std::endl;
-        printUsage();
-        return 1;
+        //Run based on mode
+        ModeVisitor visitor = {mode, argc, argv, dimensions, N, M, num_runs, 0};
+        if(!visitVariant(variant, visitor)) {
+            std::cout << "\n Unknown variant: " << variant << std::endl;
+            printUsage();
+            return 1;
+        }
+        if(visitor.status < 0) {
+            std::cout << "\n Unknown option: " << argv[1] << std::endl;
+            printUsage();
+            return 1;
+        }
+        if(mode == "islands" || visitor.status != 0) {
+            finishOutputs();
+            return visitor.status;
+        }
     }
     
+    finishOutputs();
+    
     std::cout << "\n=====================================================" << std::endl;
     std::cout << "✓ All tests completed!" << std::endl;
     std::cout << "=====================================================" << std::endl;
@@ -0,0 +1,35 @@
+#pragma once
+#include "chclpso_abs.h"
+#include "chppso_abs.h"
+#include <string>
+#include <vector>
+
+//Names a compile-time variant (a CHxPSO policy combination) as a value
+template<class Swarm>
+struct VariantTag {
+    typedef Swarm type;
+};
+
+//Runtime factory for the CLI: calls visitor(VariantTag<Swarm>()) for the
+//variant registered under name and returns false for an unknown name. The
+//visitor is instantiated once per variant, so the only runtime choice is this
+//branch; each run loop is compiled with its policies inlined.
+template<class Visitor>
+bool visitVariant(const std::string& name, Visitor& visitor) {
+    if(name == "chclpso") {
+        visitor(VariantTag<CHCLPSO_ABS>());
+    } else if(name == "chppso") {
+        visitor(VariantTag<CHpPSO_ABS>());
+    } else if(name == "chclpso-float") {
+        visitor(VariantTag<CHCLPSO_ABS_T<float>>());
+    } else if(name == "chppso-float") {
+        visitor(VariantTag<CHpPSO_ABS_T<float>>());
+    } else {
+        return false;
+    }
+    return true;
+}
+
+inline std::vector<std::string> variantNames() {
+    return {"chclpso", "chppso", "chclpso-float", "chppso-float"};
+}